@@ -0,0 +1,193 @@
+#pragma once
+
+#include <algorithm>
+#include <array>
+#include <cstdint>
+#if defined(_MSC_VER)
+#include <intrin.h>
+#endif
+
+// Bit tricks with a portable fallback for compilers without the builtins
+namespace BitOps {
+    inline int popcount(uint64_t word) {
+#if defined(_MSC_VER)
+        return static_cast<int>(__popcnt64(word));
+#else
+        return __builtin_popcountll(word);
+#endif
+    }
+
+    // Index of the lowest set bit; word must be non-zero
+    inline int ctz(uint64_t word) {
+#if defined(_MSC_VER)
+        unsigned long index;
+        _BitScanForward64(&index, word);
+        return static_cast<int>(index);
+#else
+        return __builtin_ctzll(word);
+#endif
+    }
+}
+
+// One 64-bit word per board row, bit x of rows[y] being cell (x, y). Whole
+// rows are combined at once, so shifts, dilation and region counts cost a few
+// word operations per row instead of a loop over cells. Bits beyond width
+// and rows beyond height are kept clear by every operation.
+class BitBoard {
+public:
+    static constexpr int MAX_SIZE = 64;
+
+private:
+    std::array<uint64_t, MAX_SIZE> rows{};
+    int width, height;
+    
+    uint64_t rowMask() const { return width >= 64 ? ~uint64_t{0} : (uint64_t{1} << width) - 1; }
+    // Bits x0..x1 of a row, for an already clipped span
+    static uint64_t spanMask(int x0, int x1) {
+        uint64_t upper = x1 >= 63 ? ~uint64_t{0} : (uint64_t{1} << (x1 + 1)) - 1;
+        return upper & ~((uint64_t{1} << x0) - 1);
+    }
+    
+public:
+    BitBoard(int w = 0, int h = 0) : width(w), height(h) {}
+    
+    int getWidth() const { return width; }
+    int getHeight() const { return height; }
+    uint64_t row(int y) const { return rows[y]; }
+    
+    void set(int x, int y, bool value = true) {
+        if (x >= 0 && x < width && y >= 0 && y < height) {
+            uint64_t bit = uint64_t{1} << x;
+            rows[y] = value ? (rows[y] | bit) : (rows[y] & ~bit);
+        }
+    }
+    
+    bool get(int x, int y) const {
+        if (x >= 0 && x < width && y >= 0 && y < height) {
+            return (rows[y] >> x) & 1;
+        }
+        return false;
+    }
+    
+    void clear() { rows.fill(0); }
+    int count() const {
+        int total = 0;
+        for (int y = 0; y < height; ++y) total += BitOps::popcount(rows[y]);
+        return total;
+    }
+    bool any() const {
+        for (int y = 0; y < height; ++y) {
+            if (rows[y]) return true;
+        }
+        return false;
+    }
+    
+    // Set cells inside the rectangle [x0, x1] x [y0, y1], clipped to the board
+    int countInRect(int x0, int y0, int x1, int y1) const {
+        x0 = std::max(x0, 0);
+        y0 = std::max(y0, 0);
+        x1 = std::min(x1, width - 1);
+        y1 = std::min(y1, height - 1);
+        if (x0 > x1 || y0 > y1) return 0;
+        uint64_t mask = spanMask(x0, x1);
+        int total = 0;
+        for (int y = y0; y <= y1; ++y) total += BitOps::popcount(rows[y] & mask);
+        return total;
+    }
+    
+    // Calls fn(x, y) for every set cell inside the clipped rectangle, row by row
+    template<typename Fn>
+    void forEachInRect(int x0, int y0, int x1, int y1, Fn&& fn) const {
+        x0 = std::max(x0, 0);
+        y0 = std::max(y0, 0);
+        x1 = std::min(x1, width - 1);
+        y1 = std::min(y1, height - 1);
+        if (x0 > x1 || y0 > y1) return;
+        uint64_t mask = spanMask(x0, x1);
+        for (int y = y0; y <= y1; ++y) {
+            for (uint64_t bits = rows[y] & mask; bits != 0; bits &= bits - 1) {
+                fn(BitOps::ctz(bits), y);
+            }
+        }
+    }
+    
+    template<typename Fn>
+    void forEachSet(Fn&& fn) const {
+        for (int y = 0; y < height; ++y) {
+            for (uint64_t bits = rows[y]; bits != 0; bits &= bits - 1) {
+                fn(BitOps::ctz(bits), y);
+            }
+        }
+    }
+    
+    // Whole-board shifts; cells pushed off the edge are dropped
+    BitBoard shiftUp() const {
+        BitBoard result(width, height);
+        for (int y = 0; y + 1 < height; ++y) result.rows[y] = rows[y + 1];
+        return result;
+    }
+    BitBoard shiftDown() const {
+        BitBoard result(width, height);
+        for (int y = 1; y < height; ++y) result.rows[y] = rows[y - 1];
+        return result;
+    }
+    BitBoard shiftLeft() const {
+        BitBoard result(width, height);
+        for (int y = 0; y < height; ++y) result.rows[y] = rows[y] >> 1;
+        return result;
+    }
+    BitBoard shiftRight() const {
+        BitBoard result(width, height);
+        uint64_t mask = rowMask();
+        for (int y = 0; y < height; ++y) result.rows[y] = (rows[y] << 1) & mask;
+        return result;
+    }
+    
+    // This board grown by one 4-connected step, restricted to passable cells
+    BitBoard dilate(const BitBoard& passable) const {
+        BitBoard result(width, height);
+        uint64_t mask = rowMask();
+        for (int y = 0; y < height; ++y) {
+            uint64_t grown = rows[y] | (rows[y] << 1) | (rows[y] >> 1);
+            if (y > 0) grown |= rows[y - 1];
+            if (y + 1 < height) grown |= rows[y + 1];
+            result.rows[y] = grown & mask & passable.rows[y];
+        }
+        return result;
+    }
+    
+    BitBoard operator&(const BitBoard& other) const {
+        BitBoard result(width, height);
+        for (int y = 0; y < height; ++y) result.rows[y] = rows[y] & other.rows[y];
+        return result;
+    }
+    
+    BitBoard operator|(const BitBoard& other) const {
+        BitBoard result(width, height);
+        for (int y = 0; y < height; ++y) result.rows[y] = rows[y] | other.rows[y];
+        return result;
+    }
+    
+    // Cells set here but not in other
+    BitBoard andNot(const BitBoard& other) const {
+        BitBoard result(width, height);
+        for (int y = 0; y < height; ++y) result.rows[y] = rows[y] & ~other.rows[y];
+        return result;
+    }
+    
+    BitBoard operator~() const {
+        BitBoard result(width, height);
+        uint64_t mask = rowMask();
+        for (int y = 0; y < height; ++y) result.rows[y] = ~rows[y] & mask;
+        return result;
+    }
+    
+    bool operator==(const BitBoard& other) const {
+        if (width != other.width || height != other.height) return false;
+        for (int y = 0; y < height; ++y) {
+            if (rows[y] != other.rows[y]) return false;
+        }
+        return true;
+    }
+    bool operator!=(const BitBoard& other) const { return !(*this == other); }
+};
@@ -9,6 +9,7 @@
 #include <optional>
 #include <string>
 #include <random>
+#include <algorithm>
 
 namespace {
     // Helper function to safely get environment variables
@@ -23,7 +24,8 @@ namespace {
         return std::nullopt;
     }
 
-    GameState convertGameState(const std::vector<signalr::value>& args);
+    GameState convertGameState(const std::vector<signalr::value>& args, const std::string& botId,
+                               std::shared_ptr<const MapTopology>& mapTopology);
     std::string generateGuid() {
         std::random_device rd;
         std::mt19937 gen(rd());
@@ -108,8 +110,6 @@ namespace {
         if (!val.is_map()) return {};
         auto map = val.as_map();
         Animal animal;
-        animal.id = try_get_string(map, "id");
-        animal.nickname = try_get_string(map, "nickname");
         animal.position = {try_get_int(map, "x"), try_get_int(map, "y")};
         animal.spawnPosition = {try_get_int(map, "spawnX"), try_get_int(map, "spawnY")};
         animal.score = try_get_int(map, "score");
@@ -127,9 +127,7 @@ namespace {
         if (!val.is_map()) return {};
         auto map = val.as_map();
         Zookeeper zookeeper;
-        zookeeper.id = try_get_string(map, "id");
         zookeeper.position = {try_get_int(map, "x"), try_get_int(map, "y")};
-        zookeeper.targetAnimalId = try_get_string(map, "targetAnimalId");
         zookeeper.ticksSinceTargetUpdate = try_get_int(map, "ticksSinceTargetUpdate");
         return zookeeper;
     }
@@ -150,7 +148,10 @@ namespace {
         return board;
     }
 
-    GameState convertGameState(const std::vector<signalr::value>& args) {
+    // Walls go to mapTopology, which is rebuilt only when they differ from the
+    // map it was built for; everything else goes to the returned state
+    GameState convertGameState(const std::vector<signalr::value>& args, const std::string& botId,
+                               std::shared_ptr<const MapTopology>& mapTopology) {
         if (args.empty() || !args[0].is_map()) {
             fmt::println("Error: Received invalid bot state format.");
             return {};
@@ -160,7 +161,6 @@ namespace {
         GameState state;
         state.tick = try_get_int(map, "tick");
         state.remainingTicks = try_get_int(map, "remainingTicks");
-        state.gameMode = try_get_string(map, "gameMode");
 
         if (map.count("cells") && map.at("cells").is_array()) {
             const auto& cells = map.at("cells").as_array();
@@ -184,7 +184,8 @@ namespace {
             if (gridWidth > 0 && gridHeight > 0) {
                 state.initializeGrid(gridWidth, gridHeight);
 
-                // Second pass: populate the grid using the GameState's setCell method
+                // Second pass: walls into a board for the topology, items via setCell
+                BitBoard walls(gridWidth, gridHeight);
                 for (const auto& cell_val : cells) {
                     if (!cell_val.is_map()) continue;
                     const auto& cell_map = cell_val.as_map();
@@ -193,27 +194,52 @@ namespace {
                     int y = try_get_int(cell_map, "y", -1);
                     if (x != -1 && y != -1) {
                         int content_val = try_get_int(cell_map, "content", 0); // Default to Empty
-                        state.setCell(x, y, static_cast<CellContent>(content_val));
+                        auto content = static_cast<CellContent>(content_val);
+                        if (content == CellContent::Wall) {
+                            walls.set(x, y);
+                        } else {
+                            state.setCell(x, y, content);
+                        }
                     }
                 }
+
+                // Built on the first state of a game; later ticks reuse it
+                if (!mapTopology || !mapTopology->matches(walls)) {
+                    mapTopology = MapTopology::forWalls(walls);
+                }
+                state.setTopology(mapTopology.get());
             }
         }
 
+        // Server ids are resolved to handles here; nothing past this point sees strings
+        std::vector<std::string> animalIds;
         if (map.count("animals") && map.at("animals").is_array()) {
             for (const auto& val : map.at("animals").as_array()) {
-                Animal animal = convertAnimal(val);
-                if (!animal.id.empty()) {
-                    state.animals.push_back(animal);
+                if (!val.is_map()) continue;
+                std::string id = try_get_string(val.as_map(), "id");
+                if (id.empty()) continue;
+                AnimalHandle handle = state.addAnimal(convertAnimal(val));
+                if (handle == INVALID_HANDLE) {
+                    fmt::println("Warning: more than {} animals, ignoring '{}'.", MAX_ANIMALS, id);
+                    continue;
+                }
+                animalIds.push_back(id);
+                if (id == botId) {
+                    state.myAnimal = handle;
                 }
             }
         }
 
         if (map.count("zookeepers") && map.at("zookeepers").is_array()) {
             for (const auto& val : map.at("zookeepers").as_array()) {
+                if (!val.is_map() || try_get_string(val.as_map(), "id").empty()) continue;
                 Zookeeper zookeeper = convertZookeeper(val);
-                if (!zookeeper.id.empty()) {
-                    state.zookeepers.push_back(zookeeper);
+                std::string targetId = try_get_string(val.as_map(), "targetAnimalId");
+                auto it = std::find(animalIds.begin(), animalIds.end(), targetId);
+                if (!targetId.empty() && it != animalIds.end()) {
+                    zookeeper.target = static_cast<AnimalHandle>(it - animalIds.begin());
                 }
+                state.addZookeeper(zookeeper);
             }
         }
 
@@ -233,8 +259,7 @@ Bot::Bot() {
     if (connection) {
         connection->on("Registered", [this](const std::vector<signalr::value>& args) {
         if (!args.empty()) {
-            std::string botId = args[0].as_string();
-            mctsService->SetBotId(botId);
+            botId = args[0].as_string();
             fmt::println("Bot registered successfully with ID: {}", botId);
         }
     });
@@ -242,8 +267,10 @@ Bot::Bot() {
 
     if (connection) {
         connection->on("GameState", [this](const std::vector<signalr::value>& args) {
-        // Record timing: Start of tick processing
-        auto tickStartTime = std::chrono::high_resolution_clock::now();
+        // Record timing: Start of tick processing. The search deadline runs
+        // from here, so conversion (and the map build on a game's first
+        // state) comes out of the same time limit.
+        auto tickStartTime = std::chrono::steady_clock::now();
         
         BotAction chosenActionType = BotAction::None; // Default/fallback action
         int currentTick = -1;
@@ -254,14 +281,14 @@ Bot::Bot() {
 
         try {
             auto conversionStartTime = std::chrono::high_resolution_clock::now();
-            GameState gameState = convertGameState(args);
+            GameState gameState = convertGameState(args, botId, mapTopology);
             auto conversionEndTime = std::chrono::high_resolution_clock::now();
             conversionDuration = std::chrono::duration_cast<std::chrono::microseconds>(conversionEndTime - conversionStartTime);
             
             currentTick = gameState.tick;
             // Ensure we process at most one action per game tick
             if (currentTick == lastProcessedTick.load()) {
-                auto tickEndTime = std::chrono::high_resolution_clock::now();
+                auto tickEndTime = std::chrono::steady_clock::now();
                 auto duration = std::chrono::duration_cast<std::chrono::microseconds>(tickEndTime - tickStartTime);
                 fmt::println("TIMING: Tick {} - SKIPPED (already processed) in {:.3f}ms (conversion: {:.3f}ms)", 
                            currentTick, duration.count() / 1000.0, conversionDuration.count() / 1000.0);
@@ -270,7 +297,7 @@ Bot::Bot() {
             lastProcessedTick = currentTick;
             
             auto mctsStartTime = std::chrono::high_resolution_clock::now();
-            MCTSResult mctsResult = mctsService->GetBestAction(gameState);
+            MCTSResult mctsResult = mctsService->GetBestAction(gameState, tickStartTime);
             auto mctsEndTime = std::chrono::high_resolution_clock::now();
             mctsDuration = std::chrono::duration_cast<std::chrono::microseconds>(mctsEndTime - mctsStartTime);
             
@@ -294,7 +321,7 @@ Bot::Bot() {
         // Send the command and record timing when complete
         connection->send("BotCommand", std::vector<signalr::value>{commandMap}, [=](std::exception_ptr exc) {
             // Record timing: End of tick processing (action sent)
-            auto tickEndTime = std::chrono::high_resolution_clock::now();
+            auto tickEndTime = std::chrono::steady_clock::now();
             auto duration = std::chrono::duration_cast<std::chrono::microseconds>(tickEndTime - tickStartTime);
             
             fmt::println("TIMING: Tick {} - Action {} sent in {:.3f}ms (conversion: {:.3f}ms, mcts: {:.3f}ms, send: {:.3f}ms)", 
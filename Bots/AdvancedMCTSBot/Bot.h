@@ -29,6 +29,9 @@ private:
     void loadConfiguration();
 
     std::unique_ptr<MctsService> mctsService;
+    // Walls and path lengths of the current map; converted states point at it
+    std::shared_ptr<const MapTopology> mapTopology;
+    std::string botId;
     std::optional<signalr::hub_connection> connection;
     std::promise<void> stop_task;
     std::atomic<int> lastProcessedTick{-1};
@@ -0,0 +1,105 @@
+#include "DistanceTable.h"
+#include <algorithm>
+#include <mutex>
+
+DistanceTable::DistanceTable(const BitBoard& walls)
+    : width(walls.getWidth()),
+      height(walls.getHeight()),
+      cellCount(static_cast<size_t>(width) * height),
+      wallBoard(walls),
+      table(cellCount * cellCount, UNREACHABLE),
+      nextHops((cellCount * cellCount + 3) / 4, 0) {
+    auto isWall = [this](size_t cell) {
+        return wallBoard.get(static_cast<int>(cell) % width, static_cast<int>(cell) / width);
+    };
+
+    // One BFS per open cell; the queue is reused across sources
+    std::vector<int> queue(cellCount);
+    for (size_t source = 0; source < cellCount; ++source) {
+        if (isWall(source)) continue;
+
+        uint16_t* row = &table[source * cellCount];
+        size_t head = 0;
+        size_t tail = 0;
+        row[source] = 0;
+        queue[tail++] = static_cast<int>(source);
+
+        while (head < tail) {
+            int cell = queue[head++];
+            int x = cell % width;
+            int y = cell / width;
+            uint16_t next = static_cast<uint16_t>(row[cell] + 1);
+
+            auto visit = [&](int neighbour) {
+                if (!isWall(neighbour) && row[neighbour] == UNREACHABLE) {
+                    row[neighbour] = next;
+                    queue[tail++] = neighbour;
+                }
+            };
+            if (y > 0) visit(cell - width);
+            if (y < height - 1) visit(cell + width);
+            if (x > 0) visit(cell - 1);
+            if (x < width - 1) visit(cell + 1);
+        }
+    }
+
+    // Paths are symmetric, so row `to` already holds every cell's distance to
+    // `to`: a first move is any neighbour one step closer to it
+    for (size_t to = 0; to < cellCount; ++to) {
+        if (isWall(to)) continue;
+        const uint16_t* row = &table[to * cellCount];
+        int tx = static_cast<int>(to) % width;
+        int ty = static_cast<int>(to) / width;
+
+        for (size_t from = 0; from < cellCount; ++from) {
+            uint16_t d = row[from];
+            if (d == 0 || d == UNREACHABLE) continue;
+            int x = static_cast<int>(from) % width;
+            int y = static_cast<int>(from) / width;
+
+            int order[4];
+            int count = 0;
+            if (tx > x) order[count++] = 3;
+            if (tx < x) order[count++] = 2;
+            if (ty > y) order[count++] = 1;
+            if (ty < y) order[count++] = 0;
+            for (int direction = 0; direction < 4; ++direction) {
+                if (std::find(order, order + count, direction) == order + count) {
+                    order[count++] = direction;
+                }
+            }
+
+            for (int direction : order) {
+                if ((direction == 0 && y == 0) || (direction == 1 && y == height - 1) ||
+                    (direction == 2 && x == 0) || (direction == 3 && x == width - 1)) {
+                    continue;
+                }
+                if (row[from + stepOffset(direction)] == d - 1) {
+                    size_t pair = from * cellCount + to;
+                    nextHops[pair / 4] |= static_cast<uint8_t>(direction << (2 * (pair % 4)));
+                    break;
+                }
+            }
+        }
+    }
+}
+
+std::shared_ptr<const DistanceTable> DistanceTable::forWalls(const BitBoard& walls) {
+    static std::mutex cacheMutex;
+    static std::vector<std::weak_ptr<const DistanceTable>> cache;
+
+    std::lock_guard<std::mutex> lock(cacheMutex);
+    cache.erase(std::remove_if(cache.begin(), cache.end(),
+                               [](const std::weak_ptr<const DistanceTable>& entry) { return entry.expired(); }),
+                cache.end());
+    for (const auto& entry : cache) {
+        auto table = entry.lock();
+        if (table && table->matches(walls)) {
+            return table;
+        }
+    }
+
+    auto table = std::make_shared<const DistanceTable>(walls);
+    cache.push_back(table);
+    return table;
+}
@@ -0,0 +1,63 @@
+#pragma once
+
+#include "BitBoard.h"
+#include <cstdint>
+#include <memory>
+#include <vector>
+
+// Shortest-path lengths between every pair of cells of one map, honouring
+// walls, plus the first move of such a path (used to step zookeepers). Walls
+// never change during a game, so a table is built once per map (one BFS per
+// open cell) and then shared read-only by every state, clone and search
+// thread through the MapTopology that owns it.
+class DistanceTable {
+public:
+    static constexpr uint16_t UNREACHABLE = 0xFFFF;
+
+    // Table for a map's walls, built on the first request for that map and
+    // shared with every later caller while someone still holds it
+    static std::shared_ptr<const DistanceTable> forWalls(const BitBoard& walls);
+
+    explicit DistanceTable(const BitBoard& walls);
+
+    int getWidth() const { return width; }
+    int getHeight() const { return height; }
+
+    // Cells are row-major indices (y * width + x); UNREACHABLE if either is a
+    // wall or they lie in disconnected regions
+    uint16_t get(int from, int to) const {
+        return table[static_cast<size_t>(from) * cellCount + to];
+    }
+
+    // Neighbour of from that starts a shortest path to to; from itself when
+    // the two coincide or no path exists. Among equally short moves the one
+    // closing the x gap comes first, then the y gap, as in the greedy chase.
+    int nextHop(int from, int to) const {
+        uint16_t d = get(from, to);
+        if (d == 0 || d == UNREACHABLE) return from;
+        size_t pair = static_cast<size_t>(from) * cellCount + to;
+        int direction = (nextHops[pair / 4] >> (2 * (pair % 4))) & 0x3;
+        return from + stepOffset(direction);
+    }
+
+    // True if this table was built for exactly these walls
+    bool matches(const BitBoard& walls) const { return walls == wallBoard; }
+
+private:
+    // Directions are packed four to a byte: 0 up, 1 down, 2 left, 3 right
+    int stepOffset(int direction) const {
+        switch (direction) {
+            case 0: return -width;
+            case 1: return width;
+            case 2: return -1;
+            default: return 1;
+        }
+    }
+
+    int width;
+    int height;
+    size_t cellCount;
+    BitBoard wallBoard;
+    std::vector<uint16_t> table;
+    std::vector<uint8_t> nextHops;
+};
@@ -0,0 +1,51 @@
+#pragma once
+
+#include <array>
+#include <cassert>
+#include <cstddef>
+
+// Vector with inline, fixed capacity. It never allocates and is trivially
+// copyable whenever T is, so structs holding it can be cloned with a memcpy.
+template<typename T, size_t N>
+class FixedVector {
+private:
+    std::array<T, N> items{};
+    size_t count = 0;
+
+public:
+    using value_type = T;
+    using iterator = T*;
+    using const_iterator = const T*;
+
+    static constexpr size_t capacity() { return N; }
+    size_t size() const { return count; }
+    bool empty() const { return count == 0; }
+    bool full() const { return count == N; }
+    void clear() { count = 0; }
+
+    void push_back(const T& value) {
+        assert(count < N);
+        if (count < N) {
+            items[count++] = value;
+        }
+    }
+
+    void pop_back() {
+        assert(count > 0);
+        --count;
+    }
+
+    T& operator[](size_t index) { return items[index]; }
+    const T& operator[](size_t index) const { return items[index]; }
+    T& front() { return items[0]; }
+    const T& front() const { return items[0]; }
+    T& back() { return items[count - 1]; }
+    const T& back() const { return items[count - 1]; }
+
+    T* data() { return items.data(); }
+    const T* data() const { return items.data(); }
+    iterator begin() { return items.data(); }
+    iterator end() { return items.data() + count; }
+    const_iterator begin() const { return items.data(); }
+    const_iterator end() const { return items.data() + count; }
+};
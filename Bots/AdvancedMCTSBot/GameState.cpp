@@ -5,45 +5,148 @@
 #include <random>
 #include <unordered_set>
 #include <limits>
+#include <stdexcept>
 
-GameState::GameState(int w, int h) : width(w), height(h), tick(0) {
+namespace {
+    constexpr int CELL_CONTENT_COUNT = 9;
+    constexpr int BOARD_CELLS = GameState::MAX_DIM * GameState::MAX_DIM;
+
+    uint64_t splitmix64(uint64_t x) {
+        x += 0x9e3779b97f4a7c15ULL;
+        x = (x ^ (x >> 30)) * 0xbf58476d1ce4e5b9ULL;
+        x = (x ^ (x >> 27)) * 0x94d049bb133111ebULL;
+        return x ^ (x >> 31);
+    }
+
+    // Random keys for everything tied to a board cell; scalar entity fields
+    // are keyed by hashing them with a per-entity seed instead.
+    struct ZobristTables {
+        std::array<std::array<uint64_t, BOARD_CELLS>, CELL_CONTENT_COUNT> cell;
+        std::array<std::array<uint64_t, BOARD_CELLS>, MAX_ANIMALS> animalPosition;
+        std::array<std::array<uint64_t, BOARD_CELLS>, MAX_ZOOKEEPERS> zookeeperPosition;
+        std::array<uint64_t, MAX_ANIMALS> animalSeed;
+        std::array<uint64_t, MAX_ZOOKEEPERS> zookeeperSeed;
+        uint64_t tickSeed;
+
+        ZobristTables() {
+            uint64_t state = 0x5a6f6f4b65657065ULL;
+            auto next = [&state]() { return splitmix64(state++); };
+            for (auto& table : cell) for (auto& key : table) key = next();
+            for (auto& table : animalPosition) for (auto& key : table) key = next();
+            for (auto& table : zookeeperPosition) for (auto& key : table) key = next();
+            for (auto& key : animalSeed) key = next();
+            for (auto& key : zookeeperSeed) key = next();
+            tickSeed = next();
+        }
+    };
+
+    const ZobristTables zobrist;
+
+    uint64_t cellKey(CellContent content, int x, int y) {
+        if (content == CellContent::Empty) return 0;
+        return zobrist.cell[static_cast<int>(content)][y * GameState::MAX_DIM + x];
+    }
+
+    int boardIndex(const Position& pos) {
+        int x = std::min(std::max(pos.x, 0), GameState::MAX_DIM - 1);
+        int y = std::min(std::max(pos.y, 0), GameState::MAX_DIM - 1);
+        return y * GameState::MAX_DIM + x;
+    }
+
+    uint64_t animalKey(AnimalHandle handle, const Animal& a) {
+        uint64_t fields = static_cast<uint64_t>(static_cast<uint32_t>(a.score)) << 32 |
+                          static_cast<uint64_t>(a.scoreStreak & 0xF) << 28 |
+                          static_cast<uint64_t>(std::min(a.ticksSinceLastPellet, 255)) << 20 |
+                          static_cast<uint64_t>(static_cast<int>(a.heldPowerUp) & 0x3) << 18 |
+                          static_cast<uint64_t>(std::min(a.powerUpDuration, 255)) << 10 |
+                          static_cast<uint64_t>(a.isCaught) << 9;
+        return zobrist.animalPosition[handle][boardIndex(a.position)] ^
+               splitmix64(zobrist.animalSeed[handle] ^ fields);
+    }
+
+    uint64_t zookeeperKey(size_t index, const Zookeeper& zk) {
+        uint64_t fields = static_cast<uint64_t>(static_cast<uint32_t>(zk.target)) << 32 |
+                          static_cast<uint32_t>(zk.ticksSinceTargetUpdate);
+        return zobrist.zookeeperPosition[index][boardIndex(zk.position)] ^
+               splitmix64(zobrist.zookeeperSeed[index] ^ fields);
+    }
+
+    uint64_t tickKey(int tick) {
+        return splitmix64(zobrist.tickSeed ^ static_cast<uint32_t>(tick));
+    }
+
+    // Movement actions for every MapTopology neighbour mask, in Up/Down/Left/Right order
+    const std::array<ActionList, 16> MOVES_BY_NEIGHBOUR_MASK = [] {
+        std::array<ActionList, 16> moves;
+        for (int mask = 0; mask < 16; ++mask) {
+            for (int bit = 0; bit < 4; ++bit) {
+                if (mask & (1 << bit)) moves[mask].push_back(static_cast<BotAction>(bit + 1));
+            }
+        }
+        return moves;
+    }();
+}
+
+GameState::GameState(int w, int h) : width(0), height(0), tick(0) {
+    zobristKey = tickKey(tick);
     if (w > 0 && h > 0) {
         initializeGrid(w, h);
     }
 }
 
 void GameState::initializeGrid(int w, int h) {
+    if (w > MAX_DIM || h > MAX_DIM) {
+        throw std::invalid_argument("Grid exceeds the supported " + std::to_string(MAX_DIM) + "x" +
+                                    std::to_string(MAX_DIM) + " map size");
+    }
     width = w;
     height = h;
-    
-    grid.resize(height);
-    for (int y = 0; y < height; ++y) {
-        grid[y].resize(width, CellContent::Empty);
-    }
+    topology = nullptr;
     
     pelletBoard = BitBoard(width, height);
     powerUpBoard = BitBoard(width, height);
-    wallBoard = BitBoard(width, height);
+    powerPelletBoard = BitBoard(width, height);
+    scavengerBoard = BitBoard(width, height);
+    mooseJuiceBoard = BitBoard(width, height);
+    visitedCells = BitBoard(width, height);
+    visitedCount = 0;
+    recomputeHash();
 }
 
 void GameState::setCell(int x, int y, CellContent content) {
+    if (content == CellContent::Wall) {
+        throw std::invalid_argument("Walls are part of the MapTopology; build one with MapTopology::forWalls");
+    }
     if (!isValidPosition(x, y)) return;
+    if (content == CellContent::Animal || content == CellContent::Zookeeper) {
+        content = CellContent::Empty;
+    }
     
-    grid[y][x] = content;
+    zobristKey ^= cellKey(itemAt(x, y), x, y) ^ cellKey(content, x, y);
     
     // Update bitboards
     pelletBoard.set(x, y, content == CellContent::Pellet || content == CellContent::PowerPellet);
+    powerPelletBoard.set(x, y, content == CellContent::PowerPellet);
     powerUpBoard.set(x, y, content == CellContent::ChameleonCloak || 
                            content == CellContent::Scavenger || 
                            content == CellContent::BigMooseJuice);
-    bool isWall = (content == CellContent::Wall);
-    wallBoard.set(x, y, isWall);
-    // if (isWall) { /* Wall logging removed */ }
+    scavengerBoard.set(x, y, content == CellContent::Scavenger);
+    mooseJuiceBoard.set(x, y, content == CellContent::BigMooseJuice);
 }
 
 CellContent GameState::getCell(int x, int y) const {
-    if (!isValidPosition(x, y)) return CellContent::Wall;
-    return grid[y][x];
+    return isTraversable(x, y) ? itemAt(x, y) : CellContent::Wall;
+}
+
+CellContent GameState::itemAt(int x, int y) const {
+    if (pelletBoard.get(x, y)) {
+        return powerPelletBoard.get(x, y) ? CellContent::PowerPellet : CellContent::Pellet;
+    }
+    if (powerUpBoard.get(x, y)) {
+        if (scavengerBoard.get(x, y)) return CellContent::Scavenger;
+        return mooseJuiceBoard.get(x, y) ? CellContent::BigMooseJuice : CellContent::ChameleonCloak;
+    }
+    return CellContent::Empty;
 }
 
 bool GameState::isValidPosition(int x, int y) const {
@@ -52,11 +155,11 @@ bool GameState::isValidPosition(int x, int y) const {
 
 bool GameState::isTraversable(int x, int y) const {
     if (!isValidPosition(x, y)) return false;
-    return !wallBoard.get(x, y);
+    return !topology || topology->isOpen(x, y);
 }
 
-std::vector<BotAction> GameState::getLegalActions(const std::string& animalId) const {
-    std::vector<BotAction> actions;
+ActionList GameState::getLegalActions(AnimalHandle animalId) const {
+    ActionList actions;
     
     const Animal* animal = getAnimal(animalId);
     if (!animal) {
@@ -69,10 +172,15 @@ std::vector<BotAction> GameState::getLegalActions(const std::string& animalId) c
     // Check movement actions
     Position pos = animal->position;
     
-    if (isTraversable(pos.x, pos.y - 1)) actions.push_back(BotAction::Up);
-    if (isTraversable(pos.x, pos.y + 1)) actions.push_back(BotAction::Down);
-    if (isTraversable(pos.x - 1, pos.y)) actions.push_back(BotAction::Left);
-    if (isTraversable(pos.x + 1, pos.y)) actions.push_back(BotAction::Right);
+    if (topology && isValidPosition(pos.x, pos.y)) {
+        // Moves out of a cell are fixed per map: one lookup of its open-neighbour mask
+        actions = MOVES_BY_NEIGHBOUR_MASK[topology->neighbourMask(topology->cellIndex(pos.x, pos.y))];
+    } else {
+        if (isTraversable(pos.x, pos.y - 1)) actions.push_back(BotAction::Up);
+        if (isTraversable(pos.x, pos.y + 1)) actions.push_back(BotAction::Down);
+        if (isTraversable(pos.x - 1, pos.y)) actions.push_back(BotAction::Left);
+        if (isTraversable(pos.x + 1, pos.y)) actions.push_back(BotAction::Right);
+    }
     
     // Check UseItem action
     if (animal->heldPowerUp != PowerUpType::None) {
@@ -87,12 +195,57 @@ std::vector<BotAction> GameState::getLegalActions(const std::string& animalId) c
     return actions;
 }
 
-void GameState::applyAction(const std::string& animalId, BotAction action) {
+StateDelta GameState::applyAction(AnimalHandle animalId, BotAction action) {
+    StateDelta delta;
+    applyAction(animalId, action, delta);
+    return delta;
+}
+
+void GameState::applyAction(AnimalHandle animalId, BotAction action, StateDelta& delta) {
+    delta.previousHash = zobristKey;
+    applyActionUnhashed(animalId, action, delta);
+
+    // Cells were rekeyed by setCell; fold in the entities this step touched.
+    // An animal's first snapshot in the delta is its state before the step.
+    zobristKey ^= tickKey(delta.previousTick) ^ tickKey(tick);
+    if (delta.actor.index == INVALID_HANDLE) return;
+
+    uint32_t rekeyed = 0;
+    auto rekeyAnimal = [this, &rekeyed](const StateDelta::AnimalRecord& before) {
+        if (rekeyed & (1u << before.index)) return;
+        rekeyed |= 1u << before.index;
+        zobristKey ^= animalKey(before.index, before.animal) ^ animalKey(before.index, animals[before.index]);
+    };
+    rekeyAnimal(delta.actor);
+    for (const auto& record : delta.captured) {
+        rekeyAnimal(record);
+    }
+    for (size_t i = 0; i < zookeepers.size(); ++i) {
+        zobristKey ^= zookeeperKey(i, delta.zookeepers[i]) ^ zookeeperKey(i, zookeepers[i]);
+    }
+}
+
+void GameState::applyActionUnhashed(AnimalHandle animalId, BotAction action, StateDelta& delta) {
+    delta.previousTick = tick;
+    delta.actor.index = INVALID_HANDLE;
+    delta.cellChanged = false;
+    delta.scavengedMask = {};
+    delta.zookeepers.clear();
+    delta.captured.clear();
+    delta.visitedCount = 0;
+
     tick++;
 
     Animal* animal = this->getAnimal(animalId);
     if (!animal) return;
 
+    delta.actor = {animalId, *animal};
+    animal->lastAction = action;
+
+    // Zookeepers are snapshotted up front: undo() restores these absolute values,
+    // which also reverts any follow-up edits made to them within the same step.
+    delta.zookeepers = zookeepers;
+
     Position oldPos = animal->position;
     Position newPos = oldPos;
 
@@ -121,18 +274,24 @@ void GameState::applyAction(const std::string& animalId, BotAction action) {
                         break;
                     case PowerUpType::Scavenger:
                         animal->powerUpDuration = 5;
-                        // Collect all pellets in 11x11 area
-                        for (int dx = -5; dx <= 5; dx++) {
-                            for (int dy = -5; dy <= 5; dy++) {
-                                int px = animal->position.x + dx;
-                                int py = animal->position.y + dy;
-                                if (this->isValidPosition(px, py) && 
-                                    this->getCell(px, py) == CellContent::Pellet) {
-                                    this->setCell(px, py, CellContent::Empty);
-                                    animal->score += animal->scoreStreak;
-                                    animal->ticksSinceLastPellet = 0;
-                                }
-                            }
+                        delta.scavengeCenter = animal->position;
+                        // Collect all pellets in 11x11 area (power pellets are left alone).
+                        // Iterate a copy: setCell clears bits of pelletBoard as we go.
+                        {
+                            const Position center = animal->position;
+                            const BitBoard pellets = pelletBoard;
+                            pellets.forEachInRect(center.x - StateDelta::SCAVENGE_RADIUS, center.y - StateDelta::SCAVENGE_RADIUS,
+                                                  center.x + StateDelta::SCAVENGE_RADIUS, center.y + StateDelta::SCAVENGE_RADIUS,
+                                                  [&](int px, int py) {
+                                if (this->getCell(px, py) != CellContent::Pellet) return;
+                                this->setCell(px, py, CellContent::Empty);
+                                animal->score += animal->scoreStreak;
+                                animal->ticksSinceLastPellet = 0;
+
+                                int bit = (py - center.y + StateDelta::SCAVENGE_RADIUS) * StateDelta::SCAVENGE_SPAN +
+                                          (px - center.x + StateDelta::SCAVENGE_RADIUS);
+                                delta.scavengedMask[bit / 64] |= uint64_t{1} << (bit % 64);
+                            });
                         }
                         // Scavenger remains equipped until replaced
                         break;
@@ -151,8 +310,10 @@ void GameState::applyAction(const std::string& animalId, BotAction action) {
     }
     
     // Update position
-        animal->position = newPos;
-    visitedCells.insert(newPos);
+    animal->position = newPos;
+    if (addVisited(newPos)) {
+        delta.visitedCells[delta.visitedCount++] = newPos;
+    }
     animal->distanceCovered++;
     
     // Handle cell content at new position
@@ -202,6 +363,11 @@ void GameState::applyAction(const std::string& animalId, BotAction action) {
             this->setCell(newPos.x, newPos.y, CellContent::Empty);
             break;
     }
+    if (this->getCell(newPos.x, newPos.y) != cellContent) {
+        delta.cellChanged = true;
+        delta.changedCell = newPos;
+        delta.previousContent = cellContent;
+    }
     
     // Update power-up durations
     if (animal->powerUpDuration > 0) {
@@ -219,32 +385,22 @@ void GameState::applyAction(const std::string& animalId, BotAction action) {
     // Simulate zookeeper movement and capture logic
     for (auto& zookeeper : this->zookeepers) {
         // Simple zookeeper AI - move towards target
-        if (!zookeeper.targetAnimalId.empty()) {
-            const Animal* target = this->getAnimal(zookeeper.targetAnimalId);
+        if (zookeeper.target != INVALID_HANDLE) {
+            const Animal* target = this->getAnimal(zookeeper.target);
             if (target) {
-                Position zkPos = zookeeper.position;
-                Position targetPos = target->position;
-                
                 // Move one step towards target
-                if (targetPos.x > zkPos.x && this->isTraversable(zkPos.x + 1, zkPos.y)) {
-                    zookeeper.position.x++;
-                } else if (targetPos.x < zkPos.x && this->isTraversable(zkPos.x - 1, zkPos.y)) {
-                    zookeeper.position.x--;
-                } else if (targetPos.y > zkPos.y && this->isTraversable(zkPos.x, zkPos.y + 1)) {
-                    zookeeper.position.y++;
-                } else if (targetPos.y < zkPos.y && this->isTraversable(zkPos.x, zkPos.y - 1)) {
-                    zookeeper.position.y--;
-                }
+                zookeeper.position = this->nextZookeeperStep(zookeeper.position, target->position);
                 
                 // Check for capture
                 if (zookeeper.position == target->position) {
-                    Animal* capturedAnimal = this->getAnimal(zookeeper.targetAnimalId);
+                    Animal* capturedAnimal = this->getAnimal(zookeeper.target);
                     if (capturedAnimal && capturedAnimal->powerUpDuration == 0) { // Not invisible
+                        delta.captured.push_back({zookeeper.target, *capturedAnimal});
                         capturedAnimal->position = capturedAnimal->spawnPosition;
                         capturedAnimal->capturedCounter++;
                         capturedAnimal->score = static_cast<int>(capturedAnimal->score * 0.8); // 20% penalty
                         capturedAnimal->scoreStreak = 1;
-                                                capturedAnimal->ticksSinceLastPellet = 0;
+                        capturedAnimal->ticksSinceLastPellet = 0;
                         capturedAnimal->isCaught = true;
                     }
                 }
@@ -258,24 +414,66 @@ void GameState::applyAction(const std::string& animalId, BotAction action) {
             
             // Find nearest viable animal
             double minDistance = std::numeric_limits<double>::max();
-            std::string nearestAnimalId;
+            AnimalHandle nearestAnimal = INVALID_HANDLE;
             
-            for (const auto& a : this->animals) {
+            for (AnimalHandle h = 0; h < static_cast<AnimalHandle>(this->animals.size()); ++h) {
+                const Animal& a = this->animals[h];
                 if (a.isViable && a.position != a.spawnPosition) {
                     double distance = zookeeper.position.manhattanDistance(a.position);
                     if (distance < minDistance) {
                         minDistance = distance;
-                        nearestAnimalId = a.id;
+                        nearestAnimal = h;
                     }
                 }
             }
             
-            zookeeper.targetAnimalId = nearestAnimalId;
+            zookeeper.target = nearestAnimal;
         }
     }
 }
 
-bool GameState::isPlayerCaught(const std::string& playerId) const {
+void GameState::undo(const StateDelta& delta) {
+    for (int i = delta.visitedCount - 1; i >= 0; --i) {
+        visitedCells.set(delta.visitedCells[i].x, delta.visitedCells[i].y, false);
+    }
+    visitedCount -= delta.visitedCount;
+
+    if (delta.actor.index != INVALID_HANDLE) {
+        zookeepers = delta.zookeepers;
+
+        // Captures are unwound newest first so the actor snapshot below wins last
+        for (size_t i = delta.captured.size(); i-- > 0;) {
+            animals[delta.captured[i].index] = delta.captured[i].animal;
+        }
+        animals[delta.actor.index] = delta.actor.animal;
+    }
+
+    if (delta.cellChanged) {
+        setCell(delta.changedCell.x, delta.changedCell.y, delta.previousContent);
+    }
+
+    for (int word = 0; word < 2; ++word) {
+        uint64_t mask = delta.scavengedMask[word];
+        for (int bit = 0; mask != 0; ++bit, mask >>= 1) {
+            if (!(mask & 1)) continue;
+            int index = word * 64 + bit;
+            int px = delta.scavengeCenter.x + index % StateDelta::SCAVENGE_SPAN - StateDelta::SCAVENGE_RADIUS;
+            int py = delta.scavengeCenter.y + index / StateDelta::SCAVENGE_SPAN - StateDelta::SCAVENGE_RADIUS;
+            setCell(px, py, CellContent::Pellet);
+        }
+    }
+
+    tick = delta.previousTick;
+    zobristKey = delta.previousHash;
+}
+
+void GameState::markVisited(const Position& pos, StateDelta& delta) {
+    if (delta.visitedCount < static_cast<int>(delta.visitedCells.size()) && addVisited(pos)) {
+        delta.visitedCells[delta.visitedCount++] = pos;
+    }
+}
+
+bool GameState::isPlayerCaught(AnimalHandle playerId) const {
     const Animal* animal = getAnimal(playerId);
     return animal && animal->isCaught;
 }
@@ -290,155 +488,165 @@ bool GameState::isTerminal() const {
 
 
 
-Animal* GameState::getAnimal(const std::string& id) {
-    auto it = std::find_if(animals.begin(), animals.end(),
-                          [&id](const Animal& a) { return a.id == id; });
-    return it != animals.end() ? &(*it) : nullptr;
+AnimalHandle GameState::addAnimal(const Animal& animal) {
+    if (animals.full()) return INVALID_HANDLE;
+    animals.push_back(animal);
+    AnimalHandle handle = static_cast<AnimalHandle>(animals.size() - 1);
+    zobristKey ^= animalKey(handle, animal);
+    return handle;
 }
 
-const Animal* GameState::getAnimal(const std::string& id) const {
-    auto it = std::find_if(animals.begin(), animals.end(),
-                          [&id](const Animal& a) { return a.id == id; });
-    return it != animals.end() ? &(*it) : nullptr;
+bool GameState::addZookeeper(const Zookeeper& zookeeper) {
+    if (zookeepers.full()) return false;
+    zookeepers.push_back(zookeeper);
+    zobristKey ^= zookeeperKey(zookeepers.size() - 1, zookeeper);
+    return true;
+}
+
+void GameState::setZookeeperPosition(size_t index, const Position& position) {
+    Zookeeper& zk = zookeepers[index];
+    zobristKey ^= zookeeperKey(index, zk);
+    zk.position = position;
+    zobristKey ^= zookeeperKey(index, zk);
+}
+
+void GameState::markCaught(AnimalHandle id) {
+    Animal* animal = getAnimal(id);
+    if (!animal || animal->isCaught) return;
+    zobristKey ^= animalKey(id, *animal);
+    animal->isCaught = true;
+    zobristKey ^= animalKey(id, *animal);
 }
 
 std::vector<Position> GameState::getNearbyPellets(const Position& pos, int radius) const {
     std::vector<Position> pellets;
-    
-    for (int dx = -radius; dx <= radius; dx++) {
-        for (int dy = -radius; dy <= radius; dy++) {
-            int x = pos.x + dx;
-            int y = pos.y + dy;
-            
-            if (isValidPosition(x, y) && 
-                (getCell(x, y) == CellContent::Pellet || getCell(x, y) == CellContent::PowerPellet)) {
-                pellets.emplace_back(x, y);
-            }
-        }
-    }
-    
+    pelletBoard.forEachInRect(pos.x - radius, pos.y - radius, pos.x + radius, pos.y + radius,
+                              [&pellets](int x, int y) { pellets.emplace_back(x, y); });
     return pellets;
 }
 
 std::vector<Position> GameState::getNearbyPowerUps(const Position& pos, int radius) const {
     std::vector<Position> powerUps;
-    
-    for (int dx = -radius; dx <= radius; dx++) {
-        for (int dy = -radius; dy <= radius; dy++) {
-            int x = pos.x + dx;
-            int y = pos.y + dy;
-            
-            if (isValidPosition(x, y)) {
-                CellContent content = getCell(x, y);
-                if (content == CellContent::ChameleonCloak || 
-                    content == CellContent::Scavenger || 
-                    content == CellContent::BigMooseJuice) {
-                    powerUps.emplace_back(x, y);
-                }
-            }
-        }
-    }
-    
+    powerUpBoard.forEachInRect(pos.x - radius, pos.y - radius, pos.x + radius, pos.y + radius,
+                               [&powerUps](int x, int y) { powerUps.emplace_back(x, y); });
     return powerUps;
 }
 
 double GameState::calculatePelletDensity(const Position& center, int radius) const {
-    int pelletCount = 0;
-    int totalCells = 0;
-    
-    for (int dx = -radius; dx <= radius; dx++) {
-        for (int dy = -radius; dy <= radius; dy++) {
-            int x = center.x + dx;
-            int y = center.y + dy;
-            
-            if (isValidPosition(x, y)) {
-                totalCells++;
-                if (getCell(x, y) == CellContent::Pellet || getCell(x, y) == CellContent::PowerPellet) {
-                    pelletCount++;
-                }
-            }
-        }
-    }
-    
-    return totalCells > 0 ? static_cast<double>(pelletCount) / totalCells : 0.0;
+    int x0 = std::max(center.x - radius, 0);
+    int y0 = std::max(center.y - radius, 0);
+    int x1 = std::min(center.x + radius, width - 1);
+    int y1 = std::min(center.y + radius, height - 1);
+    if (x0 > x1 || y0 > y1) return 0.0;
+    
+    int totalCells = (x1 - x0 + 1) * (y1 - y0 + 1);
+    int pelletCount = countPelletsInRect(x0, y0, x1, y1);
+    return static_cast<double>(pelletCount) / totalCells;
 }
 
 int GameState::countPelletsInArea(const Position& center, int radius) const {
-    int count = 0;
-    
-    for (int dx = -radius; dx <= radius; dx++) {
-        for (int dy = -radius; dy <= radius; dy++) {
-            int x = center.x + dx;
-            int y = center.y + dy;
-            
-            if (isValidPosition(x, y) && 
-                (getCell(x, y) == CellContent::Pellet || getCell(x, y) == CellContent::PowerPellet)) {
-                count++;
-            }
-        }
-    }
-    
-    return count;
+    return countPelletsInRect(center.x - radius, center.y - radius, center.x + radius, center.y + radius);
+}
+
+int GameState::countPelletsInRect(int x0, int y0, int x1, int y1) const {
+    // Only expansion-time heuristics ask, so nothing is maintained for it on
+    // the rollout path
+    return pelletBoard.countInRect(x0, y0, x1, y1);
 }
 
 int GameState::distanceToNearestPellet(const Position& pos) const {
-    if (pelletBoard.count() == 0) {
+    if (!pelletBoard.any()) {
         return -1; // No pellets remain
     }
+    if (isTraversable(pos.x, pos.y)) {
+        // Word-parallel BFS out from pos: each pass grows the reached rows by
+        // one step, and only the rows the frontier can have touched are visited
+        const uint64_t widthMask = width >= 64 ? ~uint64_t{0} : (uint64_t{1} << width) - 1;
+        auto openRow = [&](int y) { return topology ? topology->getOpen().row(y) : widthMask; };
+        std::array<uint64_t, MAX_DIM> reached{};
+        std::array<uint64_t, MAX_DIM> frontier{};
+        std::array<uint64_t, MAX_DIM> next{};
+        reached[pos.y] = frontier[pos.y] = uint64_t{1} << pos.x;
+        int top = pos.y;
+        int bottom = pos.y;
+        for (int steps = 0;; ++steps) {
+            for (int y = top; y <= bottom; ++y) {
+                if (frontier[y] & pelletBoard.row(y)) return steps;
+            }
+            int nextTop = std::max(top - 1, 0);
+            int nextBottom = std::min(bottom + 1, height - 1);
+            bool grew = false;
+            for (int y = nextTop; y <= nextBottom; ++y) {
+                uint64_t grown = frontier[y] | (frontier[y] << 1) | (frontier[y] >> 1);
+                if (y > 0) grown |= frontier[y - 1];
+                if (y + 1 < height) grown |= frontier[y + 1];
+                next[y] = grown & openRow(y) & ~reached[y];
+                reached[y] |= next[y];
+                grew |= next[y] != 0;
+            }
+            if (!grew) return -1; // Every reachable cell checked
+            for (int y = nextTop; y <= nextBottom; ++y) frontier[y] = next[y];
+            top = nextTop;
+            bottom = nextBottom;
+        }
+    }
 
     int minDist = std::numeric_limits<int>::max();
     
-    // Early termination optimization - search in expanding rings
-    int maxSearchRadius = std::max(width, height);
-    for (int radius = 0; radius <= maxSearchRadius; ++radius) {
-        bool foundPelletAtRadius = false;
-        
-        // Search the ring at this radius
+    // Search in expanding Manhattan rings. A path is never shorter than the
+    // Manhattan distance, so once the ring radius reaches the best travel
+    // distance found no further pellet can beat it.
+    int maxSearchRadius = width + height;
+    for (int radius = 0; radius <= maxSearchRadius && radius < minDist; ++radius) {
         for (int dx = -radius; dx <= radius; ++dx) {
-            for (int dy = -radius; dy <= radius; ++dy) {
-                // Only check positions that are exactly at the current radius
-                if (std::abs(dx) + std::abs(dy) != radius) continue;
-                
-                int x = pos.x + dx;
-                int y = pos.y + dy;
-                
+            int dy = radius - std::abs(dx);
+            int x = pos.x + dx;
+            
+            for (int sign = (dy == 0 ? 1 : -1); sign <= 1; sign += 2) {
+                int y = pos.y + sign * dy;
                 if (x >= 0 && x < width && y >= 0 && y < height && pelletBoard.get(x, y)) {
-                    foundPelletAtRadius = true;
-                    minDist = std::min(minDist, radius);
+                    minDist = std::min(minDist, distance(pos, Position(x, y)));
                 }
             }
         }
-        
-        // If we found a pellet at this radius, we can return early
-        if (foundPelletAtRadius) {
-            return minDist;
-        }
     }
     
     return (minDist == std::numeric_limits<int>::max()) ? -1 : minDist;
 }
 
+Position GameState::nextZookeeperStep(const Position& from, const Position& target) const {
+    if (topology && isValidPosition(from.x, from.y) && isValidPosition(target.x, target.y)) {
+        const DistanceTable& distances = topology->getDistances();
+        int fromCell = from.y * width + from.x;
+        int toCell = target.y * width + target.x;
+        if (distances.get(fromCell, toCell) != DistanceTable::UNREACHABLE) {
+            int next = distances.nextHop(fromCell, toCell);
+            return Position(next % width, next / width);
+        }
+    }
+
+    Position next = from;
+    if (target.x > from.x && isTraversable(from.x + 1, from.y)) {
+        next.x++;
+    } else if (target.x < from.x && isTraversable(from.x - 1, from.y)) {
+        next.x--;
+    } else if (target.y > from.y && isTraversable(from.x, from.y + 1)) {
+        next.y++;
+    } else if (target.y < from.y && isTraversable(from.x, from.y - 1)) {
+        next.y--;
+    }
+    return next;
+}
+
 Position GameState::predictZookeeperPosition(const Zookeeper& zk, int ticksAhead) const {
     Position predictedPos = zk.position;
     
-    if (zk.targetAnimalId.empty()) return predictedPos;
-    
-    const Animal* target = getAnimal(zk.targetAnimalId);
+    const Animal* target = getAnimal(zk.target);
     if (!target) return predictedPos;
     
-    // Simple prediction: assume zookeeper moves directly towards target
+    // Assume the zookeeper keeps chasing a target that stands still
     for (int i = 0; i < ticksAhead; i++) {
-        Position targetPos = target->position;
-        
-        if (targetPos.x > predictedPos.x && isTraversable(predictedPos.x + 1, predictedPos.y)) {
-            predictedPos.x++;
-        } else if (targetPos.x < predictedPos.x && isTraversable(predictedPos.x - 1, predictedPos.y)) {
-            predictedPos.x--;
-        } else if (targetPos.y > predictedPos.y && isTraversable(predictedPos.x, predictedPos.y + 1)) {
-            predictedPos.y++;
-        } else if (targetPos.y < predictedPos.y && isTraversable(predictedPos.x, predictedPos.y - 1)) {
-            predictedPos.y--;
-        }
+        predictedPos = nextZookeeperStep(predictedPos, target->position);
     }
     
     return predictedPos;
@@ -448,7 +656,7 @@ double GameState::getZookeeperThreat(const Position& pos) const {
     double maxThreat = 0.0;
     
     for (const auto& zk : zookeepers) {
-        double distance = pos.manhattanDistance(zk.position);
+        double distance = this->distance(pos, zk.position);
         double threat = std::max(0.0, 10.0 - distance); // Threat decreases with distance
         maxThreat = std::max(maxThreat, threat);
     }
@@ -457,48 +665,18 @@ double GameState::getZookeeperThreat(const Position& pos) const {
 }
 
 std::unique_ptr<GameState> GameState::clone() const {
-    auto clonedState = std::make_unique<GameState>(width, height);
-    
-    // Copy simple members
-    clonedState->tick = this->tick;
-    clonedState->myAnimalId = this->myAnimalId;
-    clonedState->gridWidth = this->gridWidth;
-    clonedState->gridHeight = this->gridHeight;
-    clonedState->remainingTicks = this->remainingTicks;
-    clonedState->gameMode = this->gameMode;
-
-    // Copy complex members
-    clonedState->grid = this->grid;
-    clonedState->animals = this->animals;
-    clonedState->zookeepers = this->zookeepers;
-    clonedState->pelletBoard = this->pelletBoard;
-    clonedState->powerUpBoard = this->powerUpBoard;
-    clonedState->wallBoard = this->wallBoard;
-    
-    // Copy new members
-    clonedState->visitedCells = this->visitedCells;
-
-    return clonedState;
+    // Every member is inline and trivially copyable, so this is a flat copy
+    return std::make_unique<GameState>(*this);
 }
 
-uint64_t GameState::hash() const {
-    uint64_t hash = 0;
-    
-    // Hash tick
-    hash ^= std::hash<int>()(tick) + 0x9e3779b9 + (hash << 6) + (hash >> 2);
-    
-    // Hash animal positions and scores
-    for (const auto& animal : animals) {
-        hash ^= std::hash<int>()(animal.position.x) + 0x9e3779b9 + (hash << 6) + (hash >> 2);
-        hash ^= std::hash<int>()(animal.position.y) + 0x9e3779b9 + (hash << 6) + (hash >> 2);
-        hash ^= std::hash<int>()(animal.score) + 0x9e3779b9 + (hash << 6) + (hash >> 2);
+void GameState::recomputeHash() {
+    uint64_t key = tickKey(tick);
+    (pelletBoard | powerUpBoard).forEachSet([&](int x, int y) { key ^= cellKey(itemAt(x, y), x, y); });
+    for (size_t i = 0; i < animals.size(); ++i) {
+        key ^= animalKey(static_cast<AnimalHandle>(i), animals[i]);
     }
-    
-    // Hash zookeeper positions
-    for (const auto& zk : zookeepers) {
-        hash ^= std::hash<int>()(zk.position.x) + 0x9e3779b9 + (hash << 6) + (hash >> 2);
-        hash ^= std::hash<int>()(zk.position.y) + 0x9e3779b9 + (hash << 6) + (hash >> 2);
+    for (size_t i = 0; i < zookeepers.size(); ++i) {
+        key ^= zookeeperKey(i, zookeepers[i]);
     }
-    
-    return hash;
-}
\ No newline at end of file
+    zobristKey = key;
+}
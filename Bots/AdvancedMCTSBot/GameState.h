@@ -3,10 +3,15 @@
 #include <vector>
 #include <array>
 #include <bitset>
+#include <algorithm>
 #include <memory>
 #include <unordered_map>
 #include <cstdint>
 #include <unordered_set>
+#include <type_traits>
+#include "BitBoard.h"
+#include "FixedVector.h"
+#include "MapTopology.h"
 
 enum class BotAction : int {
     None = 0,
@@ -17,6 +22,11 @@ enum class BotAction : int {
     UseItem = 5
 };
 
+constexpr int BOT_ACTION_COUNT = 6;
+
+// Inline list of actions; search code uses it so move generation never allocates
+using ActionList = FixedVector<BotAction, BOT_ACTION_COUNT>;
+
 struct BotActionCommand {
     BotAction actionType;
     int targetX = 0;
@@ -78,9 +88,15 @@ namespace std {
     };
 } // namespace std
 
+// Entities are referred to by their index in GameState::animals. Server-side
+// string ids are resolved to handles once, when a state is converted.
+using AnimalHandle = int;
+constexpr AnimalHandle INVALID_HANDLE = -1;
+
+constexpr int MAX_ANIMALS = 4;
+constexpr int MAX_ZOOKEEPERS = 4;
+
 struct Animal {
-    std::string id;
-    std::string nickname;
     Position position;
     Position spawnPosition;
     int score;
@@ -92,6 +108,8 @@ struct Animal {
     int scoreStreak;
         int ticksSinceLastPellet;
     bool isCaught = false;
+    // Last action applied to this animal; not part of the hash
+    BotAction lastAction = BotAction::None;
     
     Animal() : score(0), capturedCounter(0), distanceCovered(0), 
                isViable(true), heldPowerUp(PowerUpType::None), 
@@ -99,120 +117,194 @@ struct Animal {
 };
 
 struct Zookeeper {
-    std::string id;
-    std::string nickname;
     Position position;
     Position spawnPosition;
-    std::string targetAnimalId;
+    AnimalHandle target;
     int ticksSinceTargetUpdate;
     
-    Zookeeper() : ticksSinceTargetUpdate(0) {}
+    Zookeeper() : target(INVALID_HANDLE), ticksSinceTargetUpdate(0) {}
 };
 
-class BitBoard {
-private:
-    static constexpr int MAX_SIZE = 64;
-    std::bitset<MAX_SIZE * MAX_SIZE> bits;
-    int width, height;
-    
-public:
-    BitBoard(int w = 0, int h = 0) : width(w), height(h) {}
-    
-    void set(int x, int y, bool value = true) {
-        if (x >= 0 && x < width && y >= 0 && y < height) {
-            bits[y * width + x] = value;
-        }
-    }
-    
-    bool get(int x, int y) const {
-        if (x >= 0 && x < width && y >= 0 && y < height) {
-            return bits[y * width + x];
-        }
-        return false;
-    }
-    
-    void clear() { bits.reset(); }
-    int count() const { return static_cast<int>(bits.count()); }
-    
-    BitBoard operator&(const BitBoard& other) const {
-        BitBoard result(width, height);
-        result.bits = bits & other.bits;
-        return result;
-    }
-    
-    BitBoard operator|(const BitBoard& other) const {
-        BitBoard result(width, height);
-        result.bits = bits | other.bits;
-        return result;
-    }
+// Compact record of everything a single applyAction() call changed. Feeding it
+// back to GameState::undo() rewinds the state, so rollouts can run on one
+// scratch state instead of deep-copying it every simulation.
+struct StateDelta {
+    static constexpr int SCAVENGE_RADIUS = 5;
+    static constexpr int SCAVENGE_SPAN = 2 * SCAVENGE_RADIUS + 1;
+
+    struct AnimalRecord {
+        AnimalHandle index = INVALID_HANDLE;
+        Animal animal;
+    };
+
+    int previousTick = 0;
+    uint64_t previousHash = 0;
+    AnimalRecord actor;
+
+    // Cell overwritten by moving onto a pellet / power-up
+    bool cellChanged = false;
+    Position changedCell;
+    CellContent previousContent = CellContent::Empty;
+
+    // Pellets removed by Scavenger, as a bitmask over the 11x11 window
+    Position scavengeCenter;
+    std::array<uint64_t, 2> scavengedMask{};
+
+    // Zookeepers as they were before the step (only filled when an animal acted)
+    FixedVector<Zookeeper, MAX_ZOOKEEPERS> zookeepers;
+
+    // Animals captured this step, snapshotted before the capture was applied
+    FixedVector<AnimalRecord, MAX_ZOOKEEPERS> captured;
+
+    // Cells newly added to visitedCells (by the move and/or markVisited)
+    int visitedCount = 0;
+    std::array<Position, 2> visitedCells;
 };
 
+// Flat, trivially copyable snapshot of the game: clone() is a single memcpy.
+// hash() is a Zobrist key kept up to date by setCell, addAnimal/addZookeeper,
+// applyAction/undo and the entity setters below. Code that writes public
+// fields directly (converters, tests) must call recomputeHash() afterwards.
 class GameState {
+public:
+    static constexpr int MAX_DIM = BitBoard::MAX_SIZE;
+
 private:
     int width, height;
-    std::vector<std::vector<CellContent>> grid;
-    // BitBoard members moved to public
+    uint64_t zobristKey = 0;
+    // Shared per-map walls, neighbour masks and path lengths; not owned, see setTopology()
+    const MapTopology* topology = nullptr;
+
+    // Item kinds beyond pelletBoard/powerUpBoard, so getCell needs no per-cell
+    // array: a pellet is a power pellet if set here, a power-up a Scavenger or
+    // Big Moose Juice if set in theirs and a Chameleon Cloak otherwise
+    BitBoard powerPelletBoard;
+    BitBoard scavengerBoard;
+    BitBoard mooseJuiceBoard;
+
+    // Cells the search has stood on, with their popcount kept alongside so the
+    // count is a field read; only applyAction/markVisited/undo change either
+    BitBoard visitedCells;
+    int visitedCount = 0;
+    bool addVisited(const Position& pos) {
+        if (visitedCells.get(pos.x, pos.y)) return false;
+        visitedCells.set(pos.x, pos.y);
+        ++visitedCount;
+        return true;
+    }
+
+    void applyActionUnhashed(AnimalHandle animalId, BotAction action, StateDelta& delta);
+    // Item on an in-bounds cell, read from the boards alone
+    CellContent itemAt(int x, int y) const;
     
 public:
     int tick;
-    std::vector<Animal> animals;
-    std::vector<Zookeeper> zookeepers;
-    std::string myAnimalId;
-    BitBoard pelletBoard;
-    BitBoard powerUpBoard;
-    BitBoard wallBoard;
+    FixedVector<Animal, MAX_ANIMALS> animals;
+    FixedVector<Zookeeper, MAX_ZOOKEEPERS> zookeepers;
+    AnimalHandle myAnimal = INVALID_HANDLE;
+    BitBoard pelletBoard;   // Pellet or PowerPellet
+    BitBoard powerUpBoard;  // ChameleonCloak, Scavenger or BigMooseJuice
 
     int gridWidth = 0;
     int gridHeight = 0;
     int remainingTicks = 0;
-        std::string gameMode;
-
-    std::unordered_set<Position> visitedCells;
     
     GameState(int w = 0, int h = 0);
     
     // Core game state methods
     void initializeGrid(int w, int h);
+    // Places an item (or Empty) on a cell. Walls belong to the MapTopology and
+    // throw std::invalid_argument here; Animal and Zookeeper contents are not
+    // stored, since entities are tracked by position, and read back as Empty.
     void setCell(int x, int y, CellContent content);
     // Game state queries
     bool isTerminal() const;
-    bool isPlayerCaught(const std::string& playerId) const;
+    bool isPlayerCaught(AnimalHandle playerId) const;
     bool isTraversable(int x, int y) const;
     bool isValidPosition(int x, int y) const;
     CellContent getCell(int x, int y) const;
+    
+    // Travel distance: the shortest path around walls once a MapTopology is
+    // attached (O(1)), Manhattan distance otherwise or when no path exists
+    int distance(const Position& a, const Position& b) const {
+        if (topology && isValidPosition(a.x, a.y) && isValidPosition(b.x, b.y)) {
+            uint16_t d = topology->getDistances().get(a.y * width + a.x, b.y * width + b.x);
+            if (d != DistanceTable::UNREACHABLE) return d;
+        }
+        return a.manhattanDistance(b);
+    }
+    // Supplies the walls: a state without a topology is an open grid. It must
+    // match the grid size and outlive the state and its copies; it is dropped
+    // if the grid is re-initialised.
+    void setTopology(const MapTopology* map) { topology = map; }
+    const MapTopology* getTopology() const { return topology; }
+    const DistanceTable* getDistanceTable() const { return topology ? &topology->getDistances() : nullptr; }
     // BitBoard access
     const BitBoard& getPelletBoard() const { return pelletBoard; }
     const BitBoard& getPowerUpBoard() const { return powerUpBoard; }
-    const BitBoard& getWallBoard() const { return wallBoard; }
+    // Non-wall cells of the grid
+    BitBoard getOpenCells() const { return topology ? topology->getOpen() : ~BitBoard(width, height); }
     
     // Game logic
-    std::vector<BotAction> getLegalActions(const std::string& animalId) const;
-    void applyAction(const std::string& animalId, BotAction action);
-    
-    // Animal management
-    Animal* getAnimal(const std::string& id);
-    const Animal* getAnimal(const std::string& id) const;
-    Animal* getMyAnimal() { return getAnimal(myAnimalId); }
-    const Animal* getMyAnimal() const { return getAnimal(myAnimalId); }
+    ActionList getLegalActions(AnimalHandle animalId) const;
+    StateDelta applyAction(AnimalHandle animalId, BotAction action);
+    void applyAction(AnimalHandle animalId, BotAction action, StateDelta& delta);
+    // Reverts one applyAction(). Deltas must be undone in reverse order.
+    void undo(const StateDelta& delta);
+    // Records pos as visited; the insertion is reverted by undo(delta)
+    void markVisited(const Position& pos, StateDelta& delta);
+    bool isVisited(const Position& pos) const { return visitedCells.get(pos.x, pos.y); }
+    int getVisitedCount() const { return visitedCount; }
+    const BitBoard& getVisitedCells() const { return visitedCells; }
+
+    // Entity management (O(1) handle lookups)
+    AnimalHandle addAnimal(const Animal& animal);
+    bool addZookeeper(const Zookeeper& zookeeper);
+    // Key-maintaining updates for code that moves entities outside applyAction
+    void setZookeeperPosition(size_t index, const Position& position);
+    void markCaught(AnimalHandle id);
+    Animal* getAnimal(AnimalHandle id) {
+        return id >= 0 && id < static_cast<int>(animals.size()) ? &animals[id] : nullptr;
+    }
+    const Animal* getAnimal(AnimalHandle id) const {
+        return id >= 0 && id < static_cast<int>(animals.size()) ? &animals[id] : nullptr;
+    }
+    Animal* getMyAnimal() { return getAnimal(myAnimal); }
+    const Animal* getMyAnimal() const { return getAnimal(myAnimal); }
     
     // Utility methods
     std::vector<Position> getNearbyPellets(const Position& pos, int radius) const;
     std::vector<Position> getNearbyPowerUps(const Position& pos, int radius) const;
     double calculatePelletDensity(const Position& center, int radius) const;
     int countPelletsInArea(const Position& center, int radius) const;
-    // Returns Manhattan distance to the closest remaining pellet; returns -1 if none.
+    // Pellets and power pellets inside [x0, x1] x [y0, y1], clipped to the grid:
+    // one masked popcount per row of pelletBoard
+    int countPelletsInRect(int x0, int y0, int x1, int y1) const;
+    // Returns the travel distance to the closest remaining pellet; returns -1 if none.
+    // From an open cell this is a bit-parallel BFS, so the cost scales with the
+    // answer and nothing is maintained per pellet change. A query from a wall or
+    // other non-traversable cell has no BFS start and falls back to the old
+    // O(R^3) Manhattan-ring scan; the search only asks from animal positions
+    // and legal move targets, which are always open, so that path stays off
+    // the rollout loop.
     int distanceToNearestPellet(const Position& pos) const;
     
     // Zookeeper methods
+    // One chase step from `from` towards `target`: the shortest-path move from
+    // the topology's DistanceTable when attached, a greedy x-then-y step otherwise
+    Position nextZookeeperStep(const Position& from, const Position& target) const;
     Position predictZookeeperPosition(const Zookeeper& zk, int ticksAhead) const;
     double getZookeeperThreat(const Position& pos) const;
     
     // Cloning and hashing
     std::unique_ptr<GameState> clone() const;
-    uint64_t hash() const;
+    uint64_t hash() const { return zobristKey; }
+    void recomputeHash();
     
     // Getters
     int getWidth() const { return width; }
     int getHeight() const { return height; }
     int getTick() const { return tick; }
-};
\ No newline at end of file
+};
+
+static_assert(std::is_trivially_copyable<GameState>::value, "GameState must stay memcpy-clonable");
@@ -5,83 +5,81 @@
 #include <fstream>
 #include <iostream>
 
-// PelletDistanceHeuristic implementation
-double PelletDistanceHeuristic::evaluate(const GameState& state, const std::string& playerId, BotAction action) const {
-    const Animal* animal = state.getAnimal(playerId);
-    if (!animal) return 0.0;
-    
-    // Calculate position after action
-    Position newPos = animal->position;
-    switch (action) {
-        case BotAction::Up: newPos.y--; break;
-        case BotAction::Down: newPos.y++; break;
-        case BotAction::Left: newPos.x--; break;
-        case BotAction::Right: newPos.x++; break;
-        case BotAction::UseItem: return 0.0; // No movement
+// HeuristicContext implementation
+HeuristicContext::HeuristicContext(const GameState& state, AnimalHandle playerId, const ActionList& actions)
+    : state(state), playerId(playerId), animal(state.getAnimal(playerId)), actions(actions) {
+    if (!animal) return;
+
+    pelletCount = state.getPelletBoard().count();
+    currentThreat = state.getZookeeperThreat(animal->position);
+
+    for (BotAction action : actions) {
+        int index = static_cast<int>(action);
+        Position newPos = animal->position;
+        switch (action) {
+            case BotAction::Up: newPos.y--; break;
+            case BotAction::Down: newPos.y++; break;
+            case BotAction::Left: newPos.x--; break;
+            case BotAction::Right: newPos.x++; break;
+            default: break;
+        }
+        target[index] = newPos;
+        onGrid[index] = state.isValidPosition(newPos.x, newPos.y);
+        if (!onGrid[index]) continue;
+
+        content[index] = state.getCell(newPos.x, newPos.y);
+
+        nearestPellet[index] = HeuristicUtils::nearestInWindow(state, state.getPelletBoard(), newPos, PELLET_SEARCH_RADIUS);
+
+        double minDistance = std::numeric_limits<double>::max();
+        for (const auto& zookeeper : state.zookeepers) {
+            minDistance = std::min(minDistance, static_cast<double>(state.distance(newPos, zookeeper.position)));
+        }
+        nearestZookeeper[index] = minDistance;
     }
-    
-    if (!state.isValidPosition(newPos.x, newPos.y)) return -1000.0;
+}
+
+// PelletDistanceHeuristic implementation
+double PelletDistanceHeuristic::feature(const HeuristicContext& context, BotAction action) const {
+    if (!context.animal || !HeuristicContext::isMove(action)) return 0.0; // No movement
+    int index = static_cast<int>(action);
     
     // Find nearest pellet
-    double minDistance = std::numeric_limits<double>::max();
-    auto nearbyPellets = state.getNearbyPellets(newPos, 10);
-    
-    for (const auto& pelletPos : nearbyPellets) {
-        double distance = newPos.manhattanDistance(pelletPos);
-        minDistance = std::min(minDistance, distance);
-    }
-    
+    double minDistance = context.nearestPellet[index];
     if (minDistance == std::numeric_limits<double>::max()) {
         return 0.0; // No pellets found
     }
     
     // Return inverse distance (closer is better)
-    return weight * (20.0 - minDistance) / 20.0;
+    return (20.0 - minDistance) / 20.0;
 }
 
 // PelletDensityHeuristic implementation
-double PelletDensityHeuristic::evaluate(const GameState& state, const std::string& playerId, BotAction action) const {
-    const Animal* animal = state.getAnimal(playerId);
-    if (!animal) return 0.0;
-    
-    Position newPos = animal->position;
-    switch (action) {
-        case BotAction::Up: newPos.y--; break;
-        case BotAction::Down: newPos.y++; break;
-        case BotAction::Left: newPos.x--; break;
-        case BotAction::Right: newPos.x++; break;
-        case BotAction::UseItem: return 0.0;
-    }
+double PelletDensityHeuristic::feature(const HeuristicContext& context, BotAction action) const {
+    if (!context.animal || !HeuristicContext::isMove(action)) return 0.0;
+    int index = static_cast<int>(action);
     
-    if (!state.isValidPosition(newPos.x, newPos.y)) return -1000.0;
-    
-    double density = state.calculatePelletDensity(newPos, searchRadius);
-    return weight * density * 100.0;
+    double density = context.state.calculatePelletDensity(context.target[index], searchRadius);
+    return density * 100.0;
 }
 
 // ScoreStreakHeuristic implementation
-double ScoreStreakHeuristic::evaluate(const GameState& state, const std::string& playerId, BotAction action) const {
-    const Animal* animal = state.getAnimal(playerId);
+double ScoreStreakHeuristic::feature(const HeuristicContext& context, BotAction action) const {
+    const Animal* animal = context.animal;
     if (!animal) return 0.0;
     
-    Position newPos = animal->position;
-    switch (action) {
-        case BotAction::Up: newPos.y--; break;
-        case BotAction::Down: newPos.y++; break;
-        case BotAction::Left: newPos.x--; break;
-        case BotAction::Right: newPos.x++; break;
-        case BotAction::UseItem: 
-            // Using power-ups can be beneficial for maintaining streaks
-            if (animal->heldPowerUp == PowerUpType::Scavenger) {
-                return weight * 50.0; // High value for scavenger usage
-            }
-            return weight * 10.0;
+    if (action == BotAction::UseItem) {
+        // Using power-ups can be beneficial for maintaining streaks
+        if (animal->heldPowerUp == PowerUpType::Scavenger) {
+            return 50.0; // High value for scavenger usage
+        }
+        return 10.0;
     }
     
-    if (!state.isValidPosition(newPos.x, newPos.y)) return -1000.0;
+    int index = static_cast<int>(action);
     
     // Check if moving to a pellet
-    CellContent content = state.getCell(newPos.x, newPos.y);
+    CellContent content = context.content[index];
     if (content == CellContent::Pellet || content == CellContent::PowerPellet) {
         // Bonus based on current streak
         double streakBonus = animal->scoreStreak * 10.0;
@@ -91,107 +89,79 @@ double ScoreStreakHeuristic::evaluate(const GameState& state, const std::string&
             streakBonus += 30.0; // Urgent pellet collection
         }
         
-        return weight * streakBonus;
+        return streakBonus;
     }
     
     // Penalty for moves that don't collect pellets when streak is at risk
     if (animal->ticksSinceLastPellet >= 2) {
-        return weight * -20.0;
+        return -20.0;
     }
     
     return 0.0;
 }
 
 // ZookeeperAvoidanceHeuristic implementation
-double ZookeeperAvoidanceHeuristic::evaluate(const GameState& state, const std::string& playerId, BotAction action) const {
-    const Animal* animal = state.getAnimal(playerId);
+double ZookeeperAvoidanceHeuristic::feature(const HeuristicContext& context, BotAction action) const {
+    const Animal* animal = context.animal;
     if (!animal) return 0.0;
     
-    Position newPos = animal->position;
-    switch (action) {
-        case BotAction::Up: newPos.y--; break;
-        case BotAction::Down: newPos.y++; break;
-        case BotAction::Left: newPos.x--; break;
-        case BotAction::Right: newPos.x++; break;
-        case BotAction::UseItem:
-            // Using chameleon cloak is highly valuable when near zookeepers
-            if (animal->heldPowerUp == PowerUpType::ChameleonCloak) {
-                double threat = state.getZookeeperThreat(animal->position);
-                return weight * threat * 20.0;
-            }
-            return 0.0;
+    if (action == BotAction::UseItem) {
+        // Using chameleon cloak is highly valuable when near zookeepers
+        if (animal->heldPowerUp == PowerUpType::ChameleonCloak) {
+            return context.currentThreat * 20.0;
+        }
+        return 0.0;
     }
     
-    if (!state.isValidPosition(newPos.x, newPos.y)) return -1000.0;
-    
-    double minDistance = std::numeric_limits<double>::max();
-    for (const auto& zookeeper : state.zookeepers) {
-        double distance = newPos.manhattanDistance(zookeeper.position);
-        minDistance = std::min(minDistance, distance);
-    }
+    int index = static_cast<int>(action);
     
+    double minDistance = context.nearestZookeeper[index];
     if (minDistance < dangerRadius) {
         // Strong penalty for being too close
         double penalty = (dangerRadius - minDistance) * 20.0;
-        return weight * -penalty;
+        return -penalty;
     }
     
     // Small bonus for maintaining safe distance
-    return weight * std::min(10.0, minDistance);
+    return std::min(10.0, minDistance);
 }
 
 // ZookeeperPredictionHeuristic implementation
-double ZookeeperPredictionHeuristic::evaluate(const GameState& state, const std::string& playerId, BotAction action) const {
-    const Animal* animal = state.getAnimal(playerId);
-    if (!animal) return 0.0;
-    
-    Position newPos = animal->position;
-    switch (action) {
-        case BotAction::Up: newPos.y--; break;
-        case BotAction::Down: newPos.y++; break;
-        case BotAction::Left: newPos.x--; break;
-        case BotAction::Right: newPos.x++; break;
-        case BotAction::UseItem: return 0.0;
-    }
+void ZookeeperPredictionHeuristic::features(const HeuristicContext& context, ActionScores& raw) const {
+    if (!context.animal) return;
+    const GameState& state = context.state;
     
-    if (!state.isValidPosition(newPos.x, newPos.y)) return -1000.0;
-    
-    double totalThreat = 0.0;
+    // Each zookeeper's predicted path is the same for every action, so it is
+    // stepped once and checked against all candidate cells
     for (const auto& zookeeper : state.zookeepers) {
+        const Animal* target = state.getAnimal(zookeeper.target);
+        Position predictedPos = zookeeper.position;
         for (int step = 1; step <= predictionSteps; ++step) {
-            Position predictedPos = state.predictZookeeperPosition(zookeeper, step);
-            double distance = newPos.manhattanDistance(predictedPos);
-            
-            if (distance < 3) {
-                // High threat if zookeeper will be very close
-                totalThreat += (3.0 - distance) * (predictionSteps - step + 1) * 10.0;
+            if (target) {
+                predictedPos = state.nextZookeeperStep(predictedPos, target->position);
+            }
+            for (BotAction action : context.actions) {
+                int index = static_cast<int>(action);
+                if (!HeuristicContext::isMove(action) || !context.onGrid[index]) continue;
+                double distance = state.distance(context.target[index], predictedPos);
+                
+                if (distance < 3) {
+                    // High threat if zookeeper will be very close
+                    raw[index] -= (3.0 - distance) * (predictionSteps - step + 1) * 10.0;
+                }
             }
         }
     }
-    
-    return weight * -totalThreat;
 }
 
 // PowerUpCollectionHeuristic implementation
-double PowerUpCollectionHeuristic::evaluate(const GameState& state, const std::string& playerId, BotAction action) const {
-    const Animal* animal = state.getAnimal(playerId);
-    if (!animal) return 0.0;
-    
-    Position newPos = animal->position;
-    switch (action) {
-        case BotAction::Up: newPos.y--; break;
-        case BotAction::Down: newPos.y++; break;
-        case BotAction::Left: newPos.x--; break;
-        case BotAction::Right: newPos.x++; break;
-        case BotAction::UseItem: return 0.0;
-    }
-    
-    if (!state.isValidPosition(newPos.x, newPos.y)) return -1000.0;
+double PowerUpCollectionHeuristic::feature(const HeuristicContext& context, BotAction action) const {
+    if (!context.animal || !HeuristicContext::isMove(action)) return 0.0;
+    int index = static_cast<int>(action);
     
-    CellContent content = state.getCell(newPos.x, newPos.y);
     double powerUpValue = 0.0;
     
-    switch (content) {
+    switch (context.content[index]) {
         case CellContent::ChameleonCloak:
             powerUpValue = 40.0; // High value for safety
             break;
@@ -203,46 +173,39 @@ double PowerUpCollectionHeuristic::evaluate(const GameState& state, const std::s
             break;
         default:
             // Check nearby power-ups
-            auto nearbyPowerUps = state.getNearbyPowerUps(newPos, 5);
-            if (!nearbyPowerUps.empty()) {
-                double minDistance = std::numeric_limits<double>::max();
-                for (const auto& powerUpPos : nearbyPowerUps) {
-                    double distance = newPos.manhattanDistance(powerUpPos);
-                    minDistance = std::min(minDistance, distance);
-                }
+            double minDistance = HeuristicUtils::nearestInWindow(context.state, context.state.getPowerUpBoard(),
+                                                                 context.target[index], 5);
+            if (minDistance != std::numeric_limits<double>::max()) {
                 powerUpValue = (5.0 - minDistance) * 5.0;
             }
             break;
     }
     
-    return weight * powerUpValue;
+    return powerUpValue;
 }
 
 // PowerUpUsageHeuristic implementation
-double PowerUpUsageHeuristic::evaluate(const GameState& state, const std::string& playerId, BotAction action) const {
-    const Animal* animal = state.getAnimal(playerId);
+double PowerUpUsageHeuristic::feature(const HeuristicContext& context, BotAction action) const {
+    const Animal* animal = context.animal;
     if (!animal || action != BotAction::UseItem) return 0.0;
     
     double usageValue = 0.0;
     
     switch (animal->heldPowerUp) {
         case PowerUpType::ChameleonCloak:
-            {
-                double threat = state.getZookeeperThreat(animal->position);
-                usageValue = threat * 30.0; // Use when threatened
-            }
+            usageValue = context.currentThreat * 30.0; // Use when threatened
             break;
             
         case PowerUpType::Scavenger:
             {
-                int pelletsInArea = state.countPelletsInArea(animal->position, 5);
+                int pelletsInArea = context.state.countPelletsInArea(animal->position, 5);
                 usageValue = pelletsInArea * 15.0; // Use when many pellets nearby
             }
             break;
             
         case PowerUpType::BigMooseJuice:
             {
-                int pelletsInArea = state.countPelletsInArea(animal->position, 3);
+                int pelletsInArea = context.state.countPelletsInArea(animal->position, 3);
                 double streakMultiplier = animal->scoreStreak;
                 usageValue = pelletsInArea * streakMultiplier * 8.0; // Use when can maximize score
             }
@@ -252,81 +215,55 @@ double PowerUpUsageHeuristic::evaluate(const GameState& state, const std::string
             return 0.0;
     }
     
-    return weight * usageValue;
+    return usageValue;
 }
 
 // CenterControlHeuristic implementation
-double CenterControlHeuristic::evaluate(const GameState& state, const std::string& playerId, BotAction action) const {
-    const Animal* animal = state.getAnimal(playerId);
-    if (!animal) return 0.0;
-    
-    Position newPos = animal->position;
-    switch (action) {
-        case BotAction::Up: newPos.y--; break;
-        case BotAction::Down: newPos.y++; break;
-        case BotAction::Left: newPos.x--; break;
-        case BotAction::Right: newPos.x++; break;
-        case BotAction::UseItem: return 0.0;
-    }
-    
-    if (!state.isValidPosition(newPos.x, newPos.y)) return -1000.0;
+double CenterControlHeuristic::feature(const HeuristicContext& context, BotAction action) const {
+    if (!context.animal || !HeuristicContext::isMove(action)) return 0.0;
+    int index = static_cast<int>(action);
     
+    const GameState& state = context.state;
     Position center(state.getWidth() / 2, state.getHeight() / 2);
-    double distanceToCenter = newPos.manhattanDistance(center);
+    double distanceToCenter = context.target[index].manhattanDistance(center);
     double maxDistance = state.getWidth() + state.getHeight();
     
     // Prefer moderate distance from center (not too close due to zookeeper, not too far)
     double optimalDistance = maxDistance * 0.3;
     double deviation = std::abs(distanceToCenter - optimalDistance);
     
-    return weight * (maxDistance - deviation) / maxDistance * 10.0;
+    return (maxDistance - deviation) / maxDistance * 10.0;
 }
 
 // WallAvoidanceHeuristic implementation
-double WallAvoidanceHeuristic::evaluate(const GameState& state, const std::string& playerId, BotAction action) const {
-    const Animal* animal = state.getAnimal(playerId);
-    if (!animal) return 0.0;
-    
-    Position newPos = animal->position;
-    switch (action) {
-        case BotAction::Up: newPos.y--; break;
-        case BotAction::Down: newPos.y++; break;
-        case BotAction::Left: newPos.x--; break;
-        case BotAction::Right: newPos.x++; break;
-        case BotAction::UseItem: return 0.0;
-    }
-    
-    if (!state.isValidPosition(newPos.x, newPos.y)) return -1000.0;
+double WallAvoidanceHeuristic::feature(const HeuristicContext& context, BotAction action) const {
+    if (!context.animal || !HeuristicContext::isMove(action)) return 0.0;
+    int index = static_cast<int>(action);
     
     // Count traversable neighbors
+    const Position& newPos = context.target[index];
     int traversableNeighbors = 0;
     for (int dx = -1; dx <= 1; dx++) {
         for (int dy = -1; dy <= 1; dy++) {
             if (dx == 0 && dy == 0) continue;
-            if (state.isTraversable(newPos.x + dx, newPos.y + dy)) {
+            if (context.state.isTraversable(newPos.x + dx, newPos.y + dy)) {
                 traversableNeighbors++;
             }
         }
     }
     
     // Prefer positions with more escape routes
-    return weight * traversableNeighbors * 2.0;
+    return traversableNeighbors * 2.0;
 }
 
 // MovementConsistencyHeuristic implementation
-double MovementConsistencyHeuristic::evaluate(const GameState& state, const std::string& playerId, BotAction action) const {
-    auto it = lastActions.find(playerId);
-    if (it == lastActions.end()) {
-        lastActions[playerId] = action;
-        return 0.0;
-    }
-    
-    BotAction lastAction = it->second;
-    lastActions[playerId] = action;
+double MovementConsistencyHeuristic::feature(const HeuristicContext& context, BotAction action) const {
+    if (!context.animal || context.animal->lastAction == BotAction::None) return 0.0;
+    BotAction lastAction = context.animal->lastAction;
     
     // Bonus for continuing in same direction
     if (action == lastAction && action != BotAction::UseItem) {
-        return weight * 5.0;
+        return 5.0;
     }
     
     // Penalty for reversing direction
@@ -336,144 +273,96 @@ double MovementConsistencyHeuristic::evaluate(const GameState& state, const std:
                     (action == BotAction::Right && lastAction == BotAction::Left);
     
     if (isReverse) {
-        return weight * -10.0;
+        return -10.0;
     }
     
     return 0.0;
 }
 
 // TerritoryControlHeuristic implementation
-double TerritoryControlHeuristic::evaluate(const GameState& state, const std::string& playerId, BotAction action) const {
-    const Animal* animal = state.getAnimal(playerId);
-    if (!animal) return 0.0;
-    
-    Position newPos = animal->position;
-    switch (action) {
-        case BotAction::Up: newPos.y--; break;
-        case BotAction::Down: newPos.y++; break;
-        case BotAction::Left: newPos.x--; break;
-        case BotAction::Right: newPos.x++; break;
-        case BotAction::UseItem: return 0.0;
-    }
-    
-    if (!state.isValidPosition(newPos.x, newPos.y)) return -1000.0;
+double TerritoryControlHeuristic::feature(const HeuristicContext& context, BotAction action) const {
+    if (!context.animal || !HeuristicContext::isMove(action)) return 0.0;
+    int index = static_cast<int>(action);
     
-    double controlValue = HeuristicUtils::calculateAreaControl(newPos, controlRadius, state, playerId);
-    return weight * controlValue;
+    double controlValue = HeuristicUtils::calculateAreaControl(context.target[index], controlRadius,
+                                                               context.state, context.playerId);
+    return controlValue;
 }
 
 // OpponentBlockingHeuristic implementation
-double OpponentBlockingHeuristic::evaluate(const GameState& state, const std::string& playerId, BotAction action) const {
-    const Animal* animal = state.getAnimal(playerId);
-    if (!animal) return 0.0;
-    
-    Position newPos = animal->position;
-    switch (action) {
-        case BotAction::Up: newPos.y--; break;
-        case BotAction::Down: newPos.y++; break;
-        case BotAction::Left: newPos.x--; break;
-        case BotAction::Right: newPos.x++; break;
-        case BotAction::UseItem: return 0.0;
-    }
-    
-    if (!state.isValidPosition(newPos.x, newPos.y)) return -1000.0;
-    
-    double blockingValue = 0.0;
-    
-    // Check if this position blocks opponents from valuable pellets
-    for (const auto& opponent : state.animals) {
-        if (opponent.id == playerId) continue;
+void OpponentBlockingHeuristic::features(const HeuristicContext& context, ActionScores& raw) const {
+    if (!context.animal) return;
+    const GameState& state = context.state;
+    
+    // Check if each candidate position blocks opponents from valuable pellets;
+    // an opponent's pellets and distances are found once for all actions
+    for (AnimalHandle h = 0; h < static_cast<AnimalHandle>(state.animals.size()); ++h) {
+        if (h == context.playerId) continue;
+        const Animal& opponent = state.animals[h];
         
-        auto nearbyPellets = state.getNearbyPellets(opponent.position, 5);
-        for (const auto& pelletPos : nearbyPellets) {
-            double opponentDistance = opponent.position.manhattanDistance(pelletPos);
-            double myDistance = newPos.manhattanDistance(pelletPos);
-            
-            if (myDistance < opponentDistance) {
-                blockingValue += (opponentDistance - myDistance) * 2.0;
+        const Position& from = opponent.position;
+        state.getPelletBoard().forEachInRect(from.x - 5, from.y - 5, from.x + 5, from.y + 5, [&](int x, int y) {
+            Position pelletPos(x, y);
+            double opponentDistance = state.distance(opponent.position, pelletPos);
+            for (BotAction action : context.actions) {
+                int index = static_cast<int>(action);
+                if (!HeuristicContext::isMove(action) || !context.onGrid[index]) continue;
+                double myDistance = state.distance(context.target[index], pelletPos);
+                
+                if (myDistance < opponentDistance) {
+                    raw[index] += (opponentDistance - myDistance) * 2.0;
+                }
             }
-        }
+        });
     }
-    
-    return weight * blockingValue;
 }
 
 // EndgameHeuristic implementation
-double EndgameHeuristic::evaluate(const GameState& state, const std::string& playerId, BotAction action) const {
-    // Determine if we're in endgame
-    int totalPellets = state.getPelletBoard().count();
+bool EndgameHeuristic::inEndgame(const HeuristicContext& context) const {
+    const GameState& state = context.state;
     int maxPellets = state.getWidth() * state.getHeight(); // Rough estimate
-    double pelletRatio = static_cast<double>(totalPellets) / maxPellets;
-    
-    if (pelletRatio > endgameThreshold) {
+    double pelletRatio = static_cast<double>(context.pelletCount) / maxPellets;
+    return pelletRatio <= endgameThreshold;
+}
+
+double EndgameHeuristic::feature(const HeuristicContext& context, BotAction action) const {
+    if (!inEndgame(context)) {
         return 0.0; // Not in endgame
     }
     
-    const Animal* animal = state.getAnimal(playerId);
-    if (!animal) return 0.0;
-    
-    Position newPos = animal->position;
-    switch (action) {
-        case BotAction::Up: newPos.y--; break;
-        case BotAction::Down: newPos.y++; break;
-        case BotAction::Left: newPos.x--; break;
-        case BotAction::Right: newPos.x++; break;
-        case BotAction::UseItem: return 0.0;
-    }
-    
-    if (!state.isValidPosition(newPos.x, newPos.y)) return -1000.0;
+    if (!context.animal || !HeuristicContext::isMove(action)) return 0.0;
+    int index = static_cast<int>(action);
     
     // In endgame, prioritize remaining pellets heavily
-    CellContent content = state.getCell(newPos.x, newPos.y);
+    CellContent content = context.content[index];
     if (content == CellContent::Pellet || content == CellContent::PowerPellet) {
-        return weight * 100.0; // Very high value for remaining pellets
+        return 100.0; // Very high value for remaining pellets
     }
     
     // Also prioritize being close to remaining pellets
-    auto nearbyPellets = state.getNearbyPellets(newPos, 10);
-    if (!nearbyPellets.empty()) {
-        double minDistance = std::numeric_limits<double>::max();
-        for (const auto& pelletPos : nearbyPellets) {
-            double distance = newPos.manhattanDistance(pelletPos);
-            minDistance = std::min(minDistance, distance);
-        }
-        return weight * (10.0 - minDistance) * 5.0;
+    double minDistance = context.nearestPellet[index];
+    if (minDistance != std::numeric_limits<double>::max()) {
+        return (10.0 - minDistance) * 5.0;
     }
     
     return 0.0;
 }
 
 // ConsecutivePelletHeuristic implementation
-double ConsecutivePelletHeuristic::evaluate(const GameState& state,
-                                            const std::string& playerId,
-                                            BotAction action) const {
-    const Animal* me = state.getAnimal(playerId);
-    if (!me) return 0.0;
+double ConsecutivePelletHeuristic::feature(const HeuristicContext& context, BotAction action) const {
+    if (!context.animal || !HeuristicContext::isMove(action)) return 0.0; // UseItem or None
+    int index = static_cast<int>(action);
+    const GameState& state = context.state;
 
     // Project next position after action
-    Position pos = me->position;
-    switch (action) {
-        case BotAction::Up:    pos.y--; break;
-        case BotAction::Down:  pos.y++; break;
-        case BotAction::Left:  pos.x--; break;
-        case BotAction::Right: pos.x++; break;
-        default: break;
-    }
-    if (!state.isValidPosition(pos.x, pos.y) || !state.isTraversable(pos.x, pos.y)) {
+    Position pos = context.target[index];
+    if (!context.onGrid[index] || !state.isTraversable(pos.x, pos.y)) {
         return 0.0;
     }
 
     // Count consecutive pellets starting from new position continuing in same direction
-    int dx = 0, dy = 0;
-    switch (action) {
-        case BotAction::Up:    dy = -1; break;
-        case BotAction::Down:  dy = 1; break;
-        case BotAction::Left:  dx = -1; break;
-        case BotAction::Right: dx = 1; break;
-        default: break;
-    }
-
-    if (dx == 0 && dy == 0) return 0.0; // UseItem or None
+    int dx = pos.x - context.animal->position.x;
+    int dy = pos.y - context.animal->position.y;
 
     int consecutive = 0;
     Position cur = pos;
@@ -489,7 +378,7 @@ double ConsecutivePelletHeuristic::evaluate(const GameState& state,
         cur.y += dy;
     }
 
-    return weight * static_cast<double>(consecutive);
+    return static_cast<double>(consecutive);
 }
 
 // HeuristicsEngine implementation
@@ -509,14 +398,17 @@ HeuristicsEngine::HeuristicsEngine(bool logging) : enableLogging(logging) {
     addHeuristic(std::make_unique<TerritoryControlHeuristic>());
     addHeuristic(std::make_unique<OpponentBlockingHeuristic>());
     addHeuristic(std::make_unique<EndgameHeuristic>());
+    usePipeline = true;
 }
 
 void HeuristicsEngine::addHeuristic(std::unique_ptr<IHeuristic> heuristic) {
+    usePipeline = false;
     heuristicWeights[heuristic->getName()] = heuristic->getWeight();
     heuristics.push_back(std::move(heuristic));
 }
 
 void HeuristicsEngine::removeHeuristic(const std::string& name) {
+    usePipeline = false;
     heuristics.erase(
         std::remove_if(heuristics.begin(), heuristics.end(),
             [&name](const std::unique_ptr<IHeuristic>& h) {
@@ -528,6 +420,7 @@ void HeuristicsEngine::removeHeuristic(const std::string& name) {
 
 void HeuristicsEngine::setHeuristicWeight(const std::string& name, double weight) {
     heuristicWeights[name] = weight;
+    pipeline.setWeight(name, weight);
     for (auto& heuristic : heuristics) {
         if (heuristic->getName() == name) {
             heuristic->setWeight(weight);
@@ -541,11 +434,16 @@ double HeuristicsEngine::getHeuristicWeight(const std::string& name) const {
     return it != heuristicWeights.end() ? it->second : 0.0;
 }
 
-double HeuristicsEngine::evaluateAction(const GameState& state, const std::string& playerId, BotAction action) const {
-    double totalScore = 0.0;
+double HeuristicsEngine::evaluateAction(const GameState& state, AnimalHandle playerId, BotAction action) const {
+    ActionList single;
+    single.push_back(action);
+    HeuristicContext context(state, playerId, single);
     
+    double totalScore = 0.0;
     for (const auto& heuristic : heuristics) {
-        double score = heuristic->evaluate(state, playerId, action);
+        ActionScores scores{};
+        heuristic->evaluateActions(context, scores);
+        double score = scores[static_cast<int>(action)];
         totalScore += score;
         
         if (enableLogging) {
@@ -556,25 +454,45 @@ double HeuristicsEngine::evaluateAction(const GameState& state, const std::strin
     return totalScore;
 }
 
-std::unordered_map<BotAction, double> HeuristicsEngine::evaluateAllActions(const GameState& state, const std::string& playerId) const {
-    std::unordered_map<BotAction, double> actionScores;
-    auto legalActions = state.getLegalActions(playerId);
+ActionScores HeuristicsEngine::evaluateAllActions(const GameState& state, AnimalHandle playerId) const {
+    if (usePipeline && !enableLogging) {
+        return pipeline.evaluateAllActions(state, playerId);
+    }
+    
+    HeuristicContext context(state, playerId, state.getLegalActions(playerId));
     
-    for (const auto& action : legalActions) {
-        actionScores[action] = evaluateAction(state, playerId, action);
+    ActionScores actionScores{};
+    for (const auto& heuristic : heuristics) {
+        if (!enableLogging) {
+            heuristic->evaluateActions(context, actionScores);
+            continue;
+        }
+        
+        ActionScores scores{};
+        heuristic->evaluateActions(context, scores);
+        for (BotAction action : context.actions) {
+            int index = static_cast<int>(action);
+            std::cout << "  " << heuristic->getName() << " [" << index << "]: " << scores[index] << std::endl;
+            actionScores[index] += scores[index];
+        }
     }
     
     return actionScores;
 }
 
 std::vector<std::pair<std::string, double>> HeuristicsEngine::getHeuristicContributions(
-    const GameState& state, const std::string& playerId, BotAction action) const {
+    const GameState& state, AnimalHandle playerId, BotAction action) const {
+    
+    ActionList single;
+    single.push_back(action);
+    HeuristicContext context(state, playerId, single);
     
     std::vector<std::pair<std::string, double>> contributions;
     
     for (const auto& heuristic : heuristics) {
-        double score = heuristic->evaluate(state, playerId, action);
-        contributions.emplace_back(heuristic->getName(), score);
+        ActionScores scores{};
+        heuristic->evaluateActions(context, scores);
+        contributions.emplace_back(heuristic->getName(), scores[static_cast<int>(action)]);
     }
     
     return contributions;
@@ -609,38 +527,29 @@ namespace HeuristicUtils {
     
     std::vector<Position> getPositionsInRadius(const Position& center, int radius, const GameState& state) {
         std::vector<Position> positions;
-        
-        for (int dx = -radius; dx <= radius; dx++) {
-            for (int dy = -radius; dy <= radius; dy++) {
-                int x = center.x + dx;
-                int y = center.y + dy;
-                
-                if (state.isValidPosition(x, y) && state.isTraversable(x, y)) {
-                    positions.emplace_back(x, y);
-                }
-            }
-        }
-        
+        state.getOpenCells().forEachInRect(center.x - radius, center.y - radius, center.x + radius, center.y + radius,
+                                           [&positions](int x, int y) { positions.emplace_back(x, y); });
         return positions;
     }
     
-    double calculateAreaControl(const Position& center, int radius, const GameState& state, const std::string& playerId) {
-        auto positions = getPositionsInRadius(center, radius, state);
-        double controlValue = 0.0;
+    double nearestInWindow(const GameState& state, const BitBoard& board, const Position& from, int radius) {
+        double minDistance = std::numeric_limits<double>::max();
+        board.forEachInRect(from.x - radius, from.y - radius, from.x + radius, from.y + radius, [&](int x, int y) {
+            minDistance = std::min(minDistance, static_cast<double>(state.distance(from, Position(x, y))));
+        });
+        return minDistance;
+    }
+    
+    double calculateAreaControl(const Position& center, int radius, const GameState& state, AnimalHandle playerId) {
+        // Every open cell is worth 1, one holding a pellet 10
+        double controlValue = 9.0 * state.countPelletsInArea(center, radius);
         
-        for (const auto& pos : positions) {
-            // Higher value for positions with pellets
-            CellContent content = state.getCell(pos.x, pos.y);
-            if (content == CellContent::Pellet || content == CellContent::PowerPellet) {
-                controlValue += 10.0;
-            } else {
-                controlValue += 1.0;
-            }
-            
+        state.getOpenCells().forEachInRect(center.x - radius, center.y - radius, center.x + radius, center.y + radius,
+                                           [&](int x, int y) {
             // Bonus for positions closer to center
-            double distance = center.manhattanDistance(pos);
-            controlValue += (radius - distance) / radius * 5.0;
-        }
+            double distance = center.manhattanDistance(Position(x, y));
+            controlValue += 1.0 + (radius - distance) / radius * 5.0;
+        });
         
         return controlValue;
     }
@@ -654,7 +563,7 @@ namespace HeuristicUtils {
         return false;
     }
     
-    double calculatePelletValue(const GameState& state, const Position& pelletPos, const std::string& playerId) {
+    double calculatePelletValue(const GameState& state, const Position& pelletPos, AnimalHandle playerId) {
         const Animal* animal = state.getAnimal(playerId);
         if (!animal) return 1.0;
         
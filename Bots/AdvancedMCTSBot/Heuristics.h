@@ -1,206 +1,378 @@
 #pragma once
 
 #include "GameState.h"
+#include <array>
+#include <string>
+#include <tuple>
 #include <unordered_map>
+#include <utility>
 #include <vector>
 #include <memory>
 
+// Per-action score table, indexed by BotAction
+using ActionScores = std::array<double, BOT_ACTION_COUNT>;
+
+// Everything several heuristics need about one state and the actions being
+// scored, worked out once per evaluation instead of once per heuristic and
+// action. Fields indexed by BotAction are only filled for `actions`.
+struct HeuristicContext {
+    // Window radius of the shared nearest-pellet search
+    static constexpr int PELLET_SEARCH_RADIUS = 10;
+    // What most heuristics give a move off the grid, regardless of weight
+    static constexpr double OFF_GRID_SCORE = -1000.0;
+
+    const GameState& state;
+    AnimalHandle playerId;
+    const Animal* animal;  // nullptr if playerId is unknown; nothing else is filled then
+    ActionList actions;
+
+    // Where each action leaves the animal (its current cell for UseItem) and
+    // whether that is inside the grid
+    std::array<Position, BOT_ACTION_COUNT> target;
+    std::array<bool, BOT_ACTION_COUNT> onGrid{};
+    std::array<CellContent, BOT_ACTION_COUNT> content{};
+    // Travel distance from target to the nearest pellet inside the
+    // PELLET_SEARCH_RADIUS window, and to the nearest zookeeper; DBL_MAX if none
+    std::array<double, BOT_ACTION_COUNT> nearestPellet{};
+    std::array<double, BOT_ACTION_COUNT> nearestZookeeper{};
+
+    int pelletCount = 0;
+    double currentThreat = 0.0; // zookeeper threat at the animal's current cell
+
+    HeuristicContext(const GameState& state, AnimalHandle playerId, const ActionList& actions);
+
+    static bool isMove(BotAction action) {
+        return action == BotAction::Up || action == BotAction::Down ||
+               action == BotAction::Left || action == BotAction::Right;
+    }
+    // A move that would leave the grid; never true for a legal action
+    bool isOffGrid(BotAction action) const {
+        return animal && isMove(action) && !onGrid[static_cast<int>(action)];
+    }
+};
+
 // Base heuristic interface
 class IHeuristic {
 public:
     virtual ~IHeuristic() = default;
-    virtual double evaluate(const GameState& state, const std::string& playerId, BotAction action) const = 0;
+    // Adds this heuristic's weighted score for every action in context.actions
+    // to scores[action]; one call covers all candidate actions
+    virtual void evaluateActions(const HeuristicContext& context, ActionScores& scores) const = 0;
     virtual std::string getName() const = 0;
     virtual double getWeight() const = 0;
     virtual void setWeight(double weight) = 0;
 };
 
+// Base for the concrete heuristics. Derived provides
+//   void features(const HeuristicContext&, ActionScores& raw) const
+// writing its unweighted value for every action of the context that stays on
+// the grid, and may hide offGridScore() for the moves that do not. Weighting
+// happens here for the engine, and in HeuristicPipeline for the static path.
+template <typename Derived>
+class HeuristicBase : public IHeuristic {
+public:
+    void evaluateActions(const HeuristicContext& context, ActionScores& scores) const override {
+        const Derived& self = static_cast<const Derived&>(*this);
+        ActionScores raw{};
+        self.features(context, raw);
+        double weight = self.Derived::getWeight();
+        for (BotAction action : context.actions) {
+            int index = static_cast<int>(action);
+            scores[index] += context.isOffGrid(action) ? self.offGridScore(context, action) : weight * raw[index];
+        }
+    }
+
+    double offGridScore(const HeuristicContext&, BotAction) const { return HeuristicContext::OFF_GRID_SCORE; }
+};
+
+// Base for heuristics that score each action on its own: Derived provides
+// double feature(const HeuristicContext&, BotAction) const
+template <typename Derived>
+class PerActionHeuristic : public HeuristicBase<Derived> {
+public:
+    void features(const HeuristicContext& context, ActionScores& raw) const {
+        for (BotAction action : context.actions) {
+            if (!context.isOffGrid(action)) {
+                raw[static_cast<int>(action)] = static_cast<const Derived*>(this)->feature(context, action);
+            }
+        }
+    }
+};
+
 // Pellet collection heuristics
-class PelletDistanceHeuristic : public IHeuristic {
+class PelletDistanceHeuristic : public PerActionHeuristic<PelletDistanceHeuristic> {
 private:
     double weight;
     
 public:
     PelletDistanceHeuristic(double w = 2.0) : weight(w) {}
-    double evaluate(const GameState& state, const std::string& playerId, BotAction action) const override;
+    double feature(const HeuristicContext& context, BotAction action) const;
     std::string getName() const override { return "PelletDistance"; }
     double getWeight() const override { return weight; }
     void setWeight(double w) override { weight = w; }
 };
 
-class PelletDensityHeuristic : public IHeuristic {
+class PelletDensityHeuristic : public PerActionHeuristic<PelletDensityHeuristic> {
 private:
     double weight;
     int searchRadius;
     
 public:
     PelletDensityHeuristic(double w = 1.5, int radius = 5) : weight(w), searchRadius(radius) {}
-    double evaluate(const GameState& state, const std::string& playerId, BotAction action) const override;
+    double feature(const HeuristicContext& context, BotAction action) const;
     std::string getName() const override { return "PelletDensity"; }
     double getWeight() const override { return weight; }
     void setWeight(double w) override { weight = w; }
 };
 
-class ScoreStreakHeuristic : public IHeuristic {
+class ScoreStreakHeuristic : public PerActionHeuristic<ScoreStreakHeuristic> {
 private:
     double weight;
     
 public:
     ScoreStreakHeuristic(double w = 1.8) : weight(w) {}
-    double evaluate(const GameState& state, const std::string& playerId, BotAction action) const override;
+    double feature(const HeuristicContext& context, BotAction action) const;
     std::string getName() const override { return "ScoreStreak"; }
     double getWeight() const override { return weight; }
     void setWeight(double w) override { weight = w; }
 };
 
 // Zookeeper avoidance heuristics
-class ZookeeperAvoidanceHeuristic : public IHeuristic {
+class ZookeeperAvoidanceHeuristic : public PerActionHeuristic<ZookeeperAvoidanceHeuristic> {
 private:
     double weight;
     int dangerRadius;
     
 public:
     ZookeeperAvoidanceHeuristic(double w = 5.0, int radius = 8) : weight(w), dangerRadius(radius) {}
-    double evaluate(const GameState& state, const std::string& playerId, BotAction action) const override;
+    double feature(const HeuristicContext& context, BotAction action) const;
     std::string getName() const override { return "ZookeeperAvoidance"; }
     double getWeight() const override { return weight; }
     void setWeight(double w) override { weight = w; }
 };
 
-class ZookeeperPredictionHeuristic : public IHeuristic {
+class ZookeeperPredictionHeuristic : public HeuristicBase<ZookeeperPredictionHeuristic> {
 private:
     double weight;
     int predictionSteps;
     
 public:
     ZookeeperPredictionHeuristic(double w = 3.5, int steps = 5) : weight(w), predictionSteps(steps) {}
-    double evaluate(const GameState& state, const std::string& playerId, BotAction action) const override;
+    void features(const HeuristicContext& context, ActionScores& raw) const;
     std::string getName() const override { return "ZookeeperPrediction"; }
     double getWeight() const override { return weight; }
     void setWeight(double w) override { weight = w; }
 };
 
 // Power-up heuristics
-class PowerUpCollectionHeuristic : public IHeuristic {
+class PowerUpCollectionHeuristic : public PerActionHeuristic<PowerUpCollectionHeuristic> {
 private:
     double weight;
     
 public:
     PowerUpCollectionHeuristic(double w = 2.5) : weight(w) {}
-    double evaluate(const GameState& state, const std::string& playerId, BotAction action) const override;
+    double feature(const HeuristicContext& context, BotAction action) const;
     std::string getName() const override { return "PowerUpCollection"; }
     double getWeight() const override { return weight; }
     void setWeight(double w) override { weight = w; }
 };
 
-class PowerUpUsageHeuristic : public IHeuristic {
+class PowerUpUsageHeuristic : public PerActionHeuristic<PowerUpUsageHeuristic> {
 private:
     double weight;
     
 public:
     PowerUpUsageHeuristic(double w = 3.0) : weight(w) {}
-    double evaluate(const GameState& state, const std::string& playerId, BotAction action) const override;
+    double feature(const HeuristicContext& context, BotAction action) const;
+    double offGridScore(const HeuristicContext&, BotAction) const { return 0.0; }
     std::string getName() const override { return "PowerUpUsage"; }
     double getWeight() const override { return weight; }
     void setWeight(double w) override { weight = w; }
 };
 
 // Movement and positioning heuristics
-class CenterControlHeuristic : public IHeuristic {
+class CenterControlHeuristic : public PerActionHeuristic<CenterControlHeuristic> {
 private:
     double weight;
     
 public:
     CenterControlHeuristic(double w = 0.8) : weight(w) {}
-    double evaluate(const GameState& state, const std::string& playerId, BotAction action) const override;
+    double feature(const HeuristicContext& context, BotAction action) const;
     std::string getName() const override { return "CenterControl"; }
     double getWeight() const override { return weight; }
     void setWeight(double w) override { weight = w; }
 };
 
-class WallAvoidanceHeuristic : public IHeuristic {
+class WallAvoidanceHeuristic : public PerActionHeuristic<WallAvoidanceHeuristic> {
 private:
     double weight;
     
 public:
     WallAvoidanceHeuristic(double w = 1.2) : weight(w) {}
-    double evaluate(const GameState& state, const std::string& playerId, BotAction action) const override;
+    double feature(const HeuristicContext& context, BotAction action) const;
     std::string getName() const override { return "WallAvoidance"; }
     double getWeight() const override { return weight; }
     void setWeight(double w) override { weight = w; }
 };
 
-class MovementConsistencyHeuristic : public IHeuristic {
+class MovementConsistencyHeuristic : public PerActionHeuristic<MovementConsistencyHeuristic> {
 private:
     double weight;
-    mutable std::unordered_map<std::string, BotAction> lastActions;
     
 public:
     MovementConsistencyHeuristic(double w = 0.6) : weight(w) {}
-    double evaluate(const GameState& state, const std::string& playerId, BotAction action) const override;
+    double feature(const HeuristicContext& context, BotAction action) const;
+    // Only the direction matters, so a move off the grid is scored like any other
+    double offGridScore(const HeuristicContext& context, BotAction action) const { return weight * feature(context, action); }
     std::string getName() const override { return "MovementConsistency"; }
     double getWeight() const override { return weight; }
     void setWeight(double w) override { weight = w; }
 };
 
 // Long corridor pellet heuristic
-class ConsecutivePelletHeuristic : public IHeuristic {
+class ConsecutivePelletHeuristic : public PerActionHeuristic<ConsecutivePelletHeuristic> {
 private:
     double weight;
     int maxLookahead;
 public:
     ConsecutivePelletHeuristic(double w = 1.0, int lookahead = 30) : weight(w), maxLookahead(lookahead) {}
-    double evaluate(const GameState& state, const std::string& playerId, BotAction action) const override;
+    double feature(const HeuristicContext& context, BotAction action) const;
+    double offGridScore(const HeuristicContext&, BotAction) const { return 0.0; }
     std::string getName() const override { return "ConsecutivePellet"; }
     double getWeight() const override { return weight; }
     void setWeight(double w) override { weight = w; }
 };
 
 // Advanced strategic heuristics
-class TerritoryControlHeuristic : public IHeuristic {
+class TerritoryControlHeuristic : public PerActionHeuristic<TerritoryControlHeuristic> {
 private:
     double weight;
     int controlRadius;
     
 public:
     TerritoryControlHeuristic(double w = 1.4, int radius = 6) : weight(w), controlRadius(radius) {}
-    double evaluate(const GameState& state, const std::string& playerId, BotAction action) const override;
+    double feature(const HeuristicContext& context, BotAction action) const;
     std::string getName() const override { return "TerritoryControl"; }
     double getWeight() const override { return weight; }
     void setWeight(double w) override { weight = w; }
 };
 
-class OpponentBlockingHeuristic : public IHeuristic {
+class OpponentBlockingHeuristic : public HeuristicBase<OpponentBlockingHeuristic> {
 private:
     double weight;
     
 public:
     OpponentBlockingHeuristic(double w = 1.0) : weight(w) {}
-    double evaluate(const GameState& state, const std::string& playerId, BotAction action) const override;
+    void features(const HeuristicContext& context, ActionScores& raw) const;
     std::string getName() const override { return "OpponentBlocking"; }
     double getWeight() const override { return weight; }
     void setWeight(double w) override { weight = w; }
 };
 
-class EndgameHeuristic : public IHeuristic {
+class EndgameHeuristic : public PerActionHeuristic<EndgameHeuristic> {
 private:
     double weight;
     double endgameThreshold;
     
+    bool inEndgame(const HeuristicContext& context) const;
+    
 public:
     EndgameHeuristic(double w = 2.0, double threshold = 0.3) : weight(w), endgameThreshold(threshold) {}
-    double evaluate(const GameState& state, const std::string& playerId, BotAction action) const override;
+    double feature(const HeuristicContext& context, BotAction action) const;
+    double offGridScore(const HeuristicContext& context, BotAction) const {
+        return inEndgame(context) ? HeuristicContext::OFF_GRID_SCORE : 0.0;
+    }
     std::string getName() const override { return "Endgame"; }
     double getWeight() const override { return weight; }
     void setWeight(double w) override { weight = w; }
 };
 
-// Heuristics engine that combines all heuristics
+// Heuristics composed at compile time. Each writes its raw features for all
+// legal actions into one row of a fixed table, and the scores are a single
+// weights x features product: no virtual calls, no name lookups and no
+// allocation on the evaluation path. Weights are looked up by getName() only
+// when they are set.
+template <typename... Heuristics>
+class HeuristicPipeline {
+public:
+    static constexpr int FEATURE_COUNT = sizeof...(Heuristics);
+
+    HeuristicPipeline() { initWeights(std::index_sequence_for<Heuristics...>{}); }
+
+    // False if no heuristic in the pipeline has that name
+    bool setWeight(const std::string& name, double weight) {
+        int index = indexOf(name, std::index_sequence_for<Heuristics...>{});
+        if (index < 0) return false;
+        weights[index] = weight;
+        return true;
+    }
+
+    double getWeight(const std::string& name) const {
+        int index = indexOf(name, std::index_sequence_for<Heuristics...>{});
+        return index >= 0 ? weights[index] : 0.0;
+    }
+
+    // Scores every legal action of playerId; the other entries stay 0. Legal
+    // moves never leave the grid, so no off-grid scores are involved.
+    ActionScores evaluateAllActions(const GameState& state, AnimalHandle playerId) const {
+        HeuristicContext context(state, playerId, state.getLegalActions(playerId));
+        std::array<ActionScores, FEATURE_COUNT> features{};
+        extractFeatures(context, features, std::index_sequence_for<Heuristics...>{});
+
+        // Fixed trip counts over contiguous rows: the inner loop vectorises
+        // across actions
+        ActionScores scores{};
+        for (int feature = 0; feature < FEATURE_COUNT; ++feature) {
+            for (int action = 0; action < BOT_ACTION_COUNT; ++action) {
+                scores[action] += weights[feature] * features[feature][action];
+            }
+        }
+        return scores;
+    }
+
+private:
+    template <size_t... I>
+    void initWeights(std::index_sequence<I...>) {
+        ((weights[I] = std::get<I>(heuristics).getWeight()), ...);
+    }
+
+    template <size_t... I>
+    int indexOf(const std::string& name, std::index_sequence<I...>) const {
+        int index = -1;
+        ((index < 0 && std::get<I>(heuristics).getName() == name ? index = static_cast<int>(I) : 0), ...);
+        return index;
+    }
+
+    template <size_t... I>
+    void extractFeatures(const HeuristicContext& context, std::array<ActionScores, FEATURE_COUNT>& features,
+                         std::index_sequence<I...>) const {
+        (std::get<I>(heuristics).features(context, features[I]), ...);
+    }
+
+    std::tuple<Heuristics...> heuristics;
+    std::array<double, FEATURE_COUNT> weights{};
+};
+
+// The engine's default heuristic set, in the order the engine adds them
+using DefaultHeuristicPipeline = HeuristicPipeline<
+    PelletDistanceHeuristic, PelletDensityHeuristic, ScoreStreakHeuristic, ConsecutivePelletHeuristic,
+    ZookeeperAvoidanceHeuristic, ZookeeperPredictionHeuristic, PowerUpCollectionHeuristic,
+    PowerUpUsageHeuristic, CenterControlHeuristic, WallAvoidanceHeuristic, MovementConsistencyHeuristic,
+    TerritoryControlHeuristic, OpponentBlockingHeuristic, EndgameHeuristic>;
+
+// Heuristics engine that combines all heuristics. Heuristics are pure
+// functions of the state (an animal's last move travels in Animal), so one
+// engine can be evaluated from every search thread at once; weights and the
+// heuristic set must not change while a search is running.
 class HeuristicsEngine {
 private:
     std::vector<std::unique_ptr<IHeuristic>> heuristics;
     std::unordered_map<std::string, double> heuristicWeights;
     bool enableLogging;
+    // Same heuristics and weights as the default set; evaluateAllActions goes
+    // through it until a heuristic is added or removed
+    DefaultHeuristicPipeline pipeline;
+    bool usePipeline = false;
     
 public:
     HeuristicsEngine(bool logging = false);
@@ -212,9 +384,11 @@ public:
     void setHeuristicWeight(const std::string& name, double weight);
     double getHeuristicWeight(const std::string& name) const;
     
-    // Evaluation
-    double evaluateAction(const GameState& state, const std::string& playerId, BotAction action) const;
-    std::unordered_map<BotAction, double> evaluateAllActions(const GameState& state, const std::string& playerId) const;
+    // Evaluation. evaluateAllActions scores every legal action from one shared
+    // context, through the static pipeline while the default set is unchanged
+    // and logging is off; illegal actions score 0.
+    double evaluateAction(const GameState& state, AnimalHandle playerId, BotAction action) const;
+    ActionScores evaluateAllActions(const GameState& state, AnimalHandle playerId) const;
     
     // Configuration
     void enableHeuristicLogging(bool enable) { enableLogging = enable; }
@@ -223,7 +397,7 @@ public:
     
     // Analysis
     std::vector<std::pair<std::string, double>> getHeuristicContributions(
-        const GameState& state, const std::string& playerId, BotAction action) const;
+        const GameState& state, AnimalHandle playerId, BotAction action) const;
     
     // Presets
     void loadAggressivePreset();
@@ -237,7 +411,11 @@ namespace HeuristicUtils {
     double calculateDistance(const Position& a, const Position& b);
     double calculateNormalizedDistance(const Position& a, const Position& b, int maxDistance);
     std::vector<Position> getPositionsInRadius(const Position& center, int radius, const GameState& state);
-    double calculateAreaControl(const Position& center, int radius, const GameState& state, const std::string& playerId);
+    // Travel distance from `from` to the nearest cell set on board within the
+    // (2 * radius + 1)^2 window around it; DBL_MAX if there is none. Scans the
+    // board in place, so it never allocates.
+    double nearestInWindow(const GameState& state, const BitBoard& board, const Position& from, int radius);
+    double calculateAreaControl(const Position& center, int radius, const GameState& state, AnimalHandle playerId);
     bool isInDangerZone(const Position& pos, const std::vector<Zookeeper>& zookeepers, int dangerRadius);
-    double calculatePelletValue(const GameState& state, const Position& pelletPos, const std::string& playerId);
+    double calculatePelletValue(const GameState& state, const Position& pelletPos, AnimalHandle playerId);
 }
\ No newline at end of file
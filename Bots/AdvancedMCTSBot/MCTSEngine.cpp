@@ -3,10 +3,11 @@
 #include <algorithm>
 #include <cmath>
 #include <chrono>
-#include <future>
 #include <iostream>
 #include <random>
-#include <sstream>
+#include <cstring>
+#include <limits>
+#include <unordered_set>
 #include <functional>
 
 thread_local std::mt19937 MCTSEngine::rng(static_cast<unsigned int>(std::chrono::steady_clock::now().time_since_epoch().count()));
@@ -14,93 +15,95 @@ thread_local std::mt19937 MCTSEngine::rng(static_cast<unsigned int>(std::chrono:
 // Modern MCTS Enhancement Implementations
 
 // TranspositionTable Implementation
-std::shared_ptr<MCTSNode> TranspositionTable::lookup(const std::string& stateHash) {
-    std::lock_guard<std::mutex> lock(tableMutex);
-    auto it = table.find(stateHash);
-    if (it != table.end()) {
-        it->second.lastAccessed = std::chrono::steady_clock::now();
-        return it->second.node.lock(); // May return nullptr if expired
+TranspositionTable::TranspositionTable(size_t capacity) {
+    size_t buckets = 1;
+    while (buckets * BUCKET_SIZE < capacity) {
+        buckets <<= 1;
     }
-    return nullptr;
+    bucketMask = buckets - 1;
+    slots.reset(new Slot[buckets * BUCKET_SIZE]);
 }
 
-void TranspositionTable::store(const std::string& stateHash, std::shared_ptr<MCTSNode> node) {
-    std::lock_guard<std::mutex> lock(tableMutex);
-    if (table.size() >= maxSize) {
-        cleanup();
-    }
-    table[stateHash] = {stateHash, node, node->getVisits(), node->getAverageReward(), 
-                       std::chrono::steady_clock::now()};
+uint64_t TranspositionTable::pack(int visits, double avgReward, uint8_t gen) {
+    float reward = static_cast<float>(avgReward);
+    uint32_t rewardBits;
+    std::memcpy(&rewardBits, &reward, sizeof(rewardBits));
+    return static_cast<uint64_t>(rewardBits) << 32 |
+           static_cast<uint64_t>(gen) << 24 |
+           static_cast<uint64_t>(std::min(visits, MAX_VISITS));
 }
 
-void TranspositionTable::cleanup() {
-    auto now = std::chrono::steady_clock::now();
-    auto it = table.begin();
-    while (it != table.end()) {
-        if (it->second.node.expired() || 
-            std::chrono::duration_cast<std::chrono::minutes>(now - it->second.lastAccessed).count() > 5) {
-            it = table.erase(it);
-        } else {
-            ++it;
-        }
-    }
+TranspositionTable::Entry TranspositionTable::unpack(uint64_t data) {
+    uint32_t rewardBits = static_cast<uint32_t>(data >> 32);
+    float reward;
+    std::memcpy(&reward, &rewardBits, sizeof(reward));
+    return {static_cast<int>(data & MAX_VISITS), reward};
 }
 
-// VirtualLoss Implementation
-void VirtualLoss::addVirtualLoss(MCTSNode* node) {
-    std::lock_guard<std::mutex> lock(lossMapMutex);
-    auto& atomicValue = virtualLosses[node];
-    double currentValue = atomicValue.load();
-    atomicValue.store(currentValue + virtualLossValue);
+bool TranspositionTable::lookup(uint64_t key, Entry& entry) const {
+    const Slot* bucket = &slots[(key & bucketMask) * BUCKET_SIZE];
+    for (size_t i = 0; i < BUCKET_SIZE; ++i) {
+        uint64_t data = bucket[i].data.load(std::memory_order_relaxed);
+        uint64_t check = bucket[i].check.load(std::memory_order_relaxed);
+        if (data != 0 && (check ^ data) == key) {
+            entry = unpack(data);
+            return true;
+        }
+    }
+    return false;
 }
 
-void VirtualLoss::removeVirtualLoss(MCTSNode* node) {
-    std::lock_guard<std::mutex> lock(lossMapMutex);
-    auto it = virtualLosses.find(node);
-    if (it != virtualLosses.end()) {
-        double currentValue = it->second.load();
-        double newValue = currentValue - virtualLossValue;
-        if (newValue <= 0) {
-            virtualLosses.erase(it);
-        } else {
-            it->second.store(newValue);
+void TranspositionTable::store(uint64_t key, int visits, double avgReward) {
+    if (visits <= 0) return; // data == 0 marks an empty slot
+    
+    const uint8_t currentGeneration = generation.load(std::memory_order_relaxed);
+    Slot* bucket = &slots[(key & bucketMask) * BUCKET_SIZE];
+    Slot* victim = nullptr;
+    int64_t victimScore = std::numeric_limits<int64_t>::max();
+    
+    for (size_t i = 0; i < BUCKET_SIZE; ++i) {
+        uint64_t data = bucket[i].data.load(std::memory_order_relaxed);
+        uint64_t check = bucket[i].check.load(std::memory_order_relaxed);
+        if (data == 0 || (check ^ data) == key) {
+            victim = &bucket[i];
+            break;
+        }
+        // Older generations go first, then the entry with the fewest visits
+        int64_t score = unpack(data).visits;
+        if (generationOf(data) == currentGeneration) {
+            score += int64_t{1} << 32;
+        }
+        if (score < victimScore) {
+            victimScore = score;
+            victim = &bucket[i];
         }
     }
+    
+    uint64_t data = pack(visits, avgReward, currentGeneration);
+    victim->check.store(key ^ data, std::memory_order_relaxed);
+    victim->data.store(data, std::memory_order_relaxed);
 }
 
-double VirtualLoss::getVirtualLoss(MCTSNode* node) const {
-    std::lock_guard<std::mutex> lock(lossMapMutex);
-    auto it = virtualLosses.find(node);
-    return it != virtualLosses.end() ? it->second.load() : 0.0;
+void TranspositionTable::newGeneration() {
+    uint8_t next = static_cast<uint8_t>(generation.load(std::memory_order_relaxed) + 1);
+    generation.store(next == 0 ? 1 : next, std::memory_order_relaxed);
 }
 
-// AMAF Implementation
-void AMAF::updateAMAF(const std::vector<BotAction>& sequence, double finalReward) {
-    std::lock_guard<std::mutex> lock(statsMutex);
-    for (BotAction action : sequence) {
-        auto& stats = globalStats[action];
-        double currentReward = stats.totalReward.load();
-        stats.totalReward.store(currentReward + finalReward);
-        int currentVisits = stats.visits.load();
-        stats.visits.store(currentVisits + 1);
+void TranspositionTable::clear() {
+    for (size_t i = 0; i < capacity(); ++i) {
+        slots[i].check.store(0, std::memory_order_relaxed);
+        slots[i].data.store(0, std::memory_order_relaxed);
     }
 }
 
-double AMAF::getAMAFValue(BotAction action) const {
-    std::lock_guard<std::mutex> lock(statsMutex);
-    auto it = globalStats.find(action);
-    if (it != globalStats.end() && it->second.visits > 0) {
-        return it->second.totalReward / it->second.visits;
+size_t TranspositionTable::size() const {
+    size_t used = 0;
+    for (size_t i = 0; i < capacity(); ++i) {
+        if (slots[i].data.load(std::memory_order_relaxed) != 0) {
+            ++used;
+        }
     }
-    return 0.0;
-}
-
-double AMAF::combinedValue(double mctsValue, BotAction action, int mctsVisits) const {
-    double amafValue = getAMAFValue(action);
-    if (mctsVisits == 0) return amafValue;
-    
-    double combinationWeight = mctsVisits / (mctsVisits + beta * mctsVisits + beta);
-    return combinationWeight * mctsValue + (1 - combinationWeight) * amafValue;
+    return used;
 }
 
 // Enhanced Bandit Algorithm Implementations
@@ -116,7 +119,6 @@ double EnhancedUCB1::calculateValue(const MCTSNode* node, const MCTSNode* parent
     double bias = 0.0;
     if (progressiveBiasWeight > 0.0) {
         // Add heuristic-based bias that decreases with visits
-        const GameState& state = node->getGameState();
         // Simple heuristic: prefer actions that lead to better positions
         bias = progressiveBiasWeight / (1.0 + node->getVisits() * 0.1);
     }
@@ -124,6 +126,18 @@ double EnhancedUCB1::calculateValue(const MCTSNode* node, const MCTSNode* parent
     return exploitation + exploration + bias;
 }
 
+void EnhancedUCB1::calculateValues(const MCTSNode::ChildStatistics& children, int parentVisits,
+                                   double* values) const {
+    const double logParentVisits = std::log(parentVisits);
+    for (int i = 0; i < BOT_ACTION_COUNT; ++i) {
+        double nodeVisits = std::max(children.visits[i], 1.0);
+        double exploration = explorationConstant * std::sqrt(logParentVisits / nodeVisits);
+        double bias = progressiveBiasWeight > 0.0 ? progressiveBiasWeight / (1.0 + children.visits[i] * 0.1) : 0.0;
+        double value = children.meanReward[i] + exploration + bias;
+        values[i] = children.visits[i] > 0.0 ? value : std::numeric_limits<double>::infinity();
+    }
+}
+
 double UCB_V::calculateValue(const MCTSNode* node, const MCTSNode* parent) const {
     if (node->getVisits() == 0) {
         return std::numeric_limits<double>::infinity();
@@ -140,6 +154,20 @@ double UCB_V::calculateValue(const MCTSNode* node, const MCTSNode* parent) const
     return exploitation + exploration + varianceScale * varianceTerm;
 }
 
+void UCB_V::calculateValues(const MCTSNode::ChildStatistics& children, int parentVisits,
+                            double* values) const {
+    const double logParentVisits = std::log(parentVisits);
+    for (int i = 0; i < BOT_ACTION_COUNT; ++i) {
+        double nodeVisits = std::max(children.visits[i], 1.0);
+        double mean = children.meanReward[i];
+        double variance = children.visits[i] > 1.0 ? children.meanSquaredReward[i] - mean * mean : 0.0;
+        double exploration = explorationConstant * std::sqrt(logParentVisits / nodeVisits);
+        double varianceTerm = std::sqrt(variance * logParentVisits / nodeVisits);
+        double value = mean + exploration + varianceScale * varianceTerm;
+        values[i] = children.visits[i] > 0.0 ? value : std::numeric_limits<double>::infinity();
+    }
+}
+
 MCTSEngine::MCTSEngine(double explorationConstant, int maxIterations, int maxSimulationDepth, 
                        int timeLimit, int numThreads)
     : explorationConstant(explorationConstant)
@@ -148,12 +176,12 @@ MCTSEngine::MCTSEngine(double explorationConstant, int maxIterations, int maxSim
     , timeLimit(std::chrono::milliseconds(timeLimit))
     , numThreads(numThreads)
     , shouldStop(false)
+    , virtualLossValue(5.0)
     , totalSimulations(0)
     , totalExpansions(0)
     , heuristicsEngine(false)
     , useTranspositionTable(true)
     , useVirtualLoss(true)
-    , useAMAF(true)
     , useProgressiveWidening(false)
     , useRAVE(true)
     , heuristicWeight(0.5) {
@@ -161,58 +189,85 @@ MCTSEngine::MCTSEngine(double explorationConstant, int maxIterations, int maxSim
     heuristicsEngine.loadBalancedPreset();
     
     // Initialize modern MCTS enhancements
-    transpositionTable = std::make_unique<TranspositionTable>(50000);
-    virtualLoss = std::make_unique<VirtualLoss>(5.0);
-    amaf = std::make_unique<AMAF>(0.3);
+    transpositionTable = std::make_unique<TranspositionTable>(1 << 16);
     banditAlgorithm = std::make_unique<UCB_V>(1.0, 0.25); // Default to UCB-V
+    
+    nodePool = std::make_unique<NodePool>();
+    sparePool = std::make_unique<NodePool>();
 }
 
 MCTSEngine::~MCTSEngine() {
     shouldStop = true;
 }
 
-std::string MCTSEngine::hashGameState(const GameState& state, const std::string& playerId) const {
-    std::ostringstream oss;
-    
-    // Hash key game state components
-    oss << "tick:" << state.tick << "|";
-    oss << "player:" << playerId << "|";
+uint64_t MCTSEngine::transpositionKey(uint64_t stateHash, AnimalHandle playerId) {
+    return stateHash ^ (static_cast<uint64_t>(playerId + 1) * 0x9e3779b97f4a7c15ULL);
+}
+
+uint64_t MCTSEngine::hashForReuse(const GameState& state, AnimalHandle playerId) const {
+    // Only what the search itself simulates: our animal, the zookeepers and the
+    // tick. Opponents are static in rollouts, so their moves (and the pellets
+    // they eat) must not prevent reuse; the promoted root takes the observed
+    // state anyway.
+    uint64_t hash = 1469598103934665603ULL;
+    auto mix = [&hash](int64_t value) {
+        hash ^= static_cast<uint64_t>(value) + 0x9e3779b97f4a7c15ULL + (hash << 6) + (hash >> 2);
+    };
     
-    // Player position and state
-    const Animal* animal = state.getAnimal(playerId);
-    if (animal) {
-        oss << "pos:" << animal->position.x << "," << animal->position.y << "|";
-        oss << "score:" << animal->score << "|";
-        oss << "streak:" << animal->scoreStreak << "|";
-        oss << "lastPellet:" << animal->ticksSinceLastPellet << "|";
-        oss << "powerUp:" << static_cast<int>(animal->heldPowerUp) << "|";
-        oss << "powerUpDur:" << animal->powerUpDuration << "|";
+    mix(state.tick);
+    mix(playerId);
+    if (const Animal* animal = state.getAnimal(playerId)) {
+        mix(animal->position.x);
+        mix(animal->position.y);
+        mix(animal->score);
+        mix(animal->scoreStreak);
+        mix(animal->ticksSinceLastPellet);
+        mix(static_cast<int>(animal->heldPowerUp));
+        mix(animal->powerUpDuration);
+        mix(animal->isCaught);
     }
-    
-    // Pellet board (simplified - only nearby pellets)
-    if (animal) {
-        for (int dx = -3; dx <= 3; ++dx) {
-            for (int dy = -3; dy <= 3; ++dy) {
-                int x = animal->position.x + dx;
-                int y = animal->position.y + dy;
-                if (x >= 0 && x < state.getWidth() && y >= 0 && y < state.getHeight()) {
-                    if (state.pelletBoard.get(x, y)) {
-                        oss << "p:" << x << "," << y << "|";
-                    }
-                }
-            }
-        }
+    for (const auto& zk : state.zookeepers) {
+        mix(zk.position.x);
+        mix(zk.position.y);
+    }
+    return hash;
+}
+
+MCTSNode* MCTSEngine::reuseSubtree(const GameState& state, AnimalHandle playerId) {
+    MCTSNode* previous = previousRoot;
+    previousRoot = nullptr;
+    if (!useTreeReuse || !previous || previous->getPlayerId() != playerId) {
+        return nullptr;
     }
     
-    // Zookeeper positions (simplified)
-    for (const auto& zk : state.zookeepers) {
-        oss << "zk:" << zk.position.x << "," << zk.position.y << "|";
+    // Children keep no state: rebuild the one we moved into from the old root
+    GameState expected = previous->getGameState();
+    expected.applyAction(playerId, previousAction);
+    if (hashForReuse(expected, playerId) != hashForReuse(state, playerId)) {
+        return nullptr;
     }
     
-    return oss.str();
+    for (MCTSNode* child : previous->getChildren()) {
+        if (child->getAction() != previousAction) {
+            continue;
+        }
+        
+        // Siblings stay in the pool as garbage until the next reset; once they
+        // dominate it, copy the surviving subtree into the spare pool instead
+        if (nodePool->nodeCount() > COMPACTION_THRESHOLD) {
+            sparePool->reset();
+            child = child->cloneSubtree(*sparePool, nullptr);
+            std::swap(nodePool, sparePool);
+            sparePool->reset();
+            if (!child) return nullptr;
+        }
+        
+        return child->promoteToRoot(*nodePool, state) ? child : nullptr;
+    }
+    return nullptr;
 }
 
-void MCTSEngine::initializeMoveOrdering(const GameState& state, const std::string& playerId) {
+void MCTSEngine::initializeMoveOrdering(const GameState& state, AnimalHandle playerId) {
     moveOrdering = {BotAction::Up, BotAction::Down, BotAction::Left, BotAction::Right};
     
     // Order moves based on simple heuristics
@@ -222,17 +277,13 @@ void MCTSEngine::initializeMoveOrdering(const GameState& state, const std::strin
         int nearestPelletDist = std::numeric_limits<int>::max();
         Position nearestPelletPos{-1, -1};
         
-        for (int y = 0; y < state.getHeight(); ++y) {
-            for (int x = 0; x < state.getWidth(); ++x) {
-                if (state.pelletBoard.get(x, y)) {
-                    int dist = std::abs(animal->position.x - x) + std::abs(animal->position.y - y);
-                    if (dist < nearestPelletDist) {
-                        nearestPelletDist = dist;
-                        nearestPelletPos = {x, y};
-                    }
-                }
+        state.pelletBoard.forEachSet([&](int x, int y) {
+            int dist = std::abs(animal->position.x - x) + std::abs(animal->position.y - y);
+            if (dist < nearestPelletDist) {
+                nearestPelletDist = dist;
+                nearestPelletPos = {x, y};
             }
-        }
+        });
         
         if (nearestPelletPos.x >= 0) {
             // Reorder moves to prioritize directions toward nearest pellet
@@ -250,7 +301,7 @@ void MCTSEngine::initializeMoveOrdering(const GameState& state, const std::strin
     }
 }
 
-std::vector<BotAction> MCTSEngine::getOrderedMoves(const GameState& state, const std::string& playerId) {
+std::vector<BotAction> MCTSEngine::getOrderedMoves(const GameState& state, AnimalHandle playerId) {
     auto legalMoves = state.getLegalActions(playerId);
     std::vector<BotAction> orderedMoves;
     
@@ -271,7 +322,7 @@ std::vector<BotAction> MCTSEngine::getOrderedMoves(const GameState& state, const
     return orderedMoves;
 }
 
-bool MCTSEngine::shouldPruneMove(BotAction action, const GameState& state, const std::string& playerId) {
+bool MCTSEngine::shouldPruneMove(BotAction action, const GameState& state, AnimalHandle playerId) {
     const Animal* animal = state.getAnimal(playerId);
     if (!animal) return false;
     
@@ -315,31 +366,72 @@ bool MCTSEngine::shouldContinueSearch(std::chrono::steady_clock::time_point star
     return elapsed < timeLimit * 0.95; // Use 95% of time limit for safety
 }
 
-MCTSResult MCTSEngine::findBestAction(const GameState& state, const std::string& playerId) {
+MCTSResult MCTSEngine::findBestAction(const GameState& state, AnimalHandle playerId,
+                                      std::chrono::steady_clock::time_point startTime) {
     resetStatistics();
     shouldStop = false;
     
     initializeMoveOrdering(state, playerId);
     
-    auto rootState = state.clone();
-    auto root = std::make_unique<MCTSNode>(std::move(rootState), nullptr, BotAction::Up, playerId);
+    // Converted states are built field by field, so their Zobrist key is not trusted
+    GameState observed = state;
+    observed.recomputeHash();
+    // The walls come with the state's topology; a state without one is an
+    // open grid and searches on Manhattan distance, with no table to build
+    // here on the clock. Topologies are shared per map, so a new one (or a
+    // resized open grid) means a new map.
+    std::shared_ptr<const MapTopology> observedTopology = observed.getTopology()
+        ? observed.getTopology()->shared_from_this()
+        : nullptr;
+    if (observedTopology != topology ||
+        observed.getWidth() != mapWidth || observed.getHeight() != mapHeight) {
+        // New map: the old tree's states point at the topology being replaced,
+        // and hashes do not cover walls, so neither tree nor table carries over
+        topology = std::move(observedTopology);
+        mapWidth = observed.getWidth();
+        mapHeight = observed.getHeight();
+        previousRoot = nullptr;
+        previousAction = BotAction::None;
+        nodePool->reset();
+        transpositionTable->clear();
+    }
+    observed.setTopology(topology.get());
+    // Observed states carry no move history; our own last move stands in
+    if (Animal* me = observed.getAnimal(playerId); me && me->lastAction == BotAction::None) {
+        me->lastAction = previousAction;
+    }
+    if (useTranspositionTable) {
+        transpositionTable->newGeneration();
+    }
     
-    auto startTime = std::chrono::steady_clock::now();
+    MCTSNode* root = reuseSubtree(observed, playerId);
+    lastReusedVisits = root ? root->getVisits() : 0;
+    if (!root) {
+        // Nothing to carry over: drop the old tree wholesale, in O(1)
+        nodePool->reset();
+        root = nodePool->createRoot(observed, playerId);
+    }
     
     if (numThreads <= 1) {
+        GameState scratch = root->getGameState();
+        RolloutBuffers& buffers = rolloutBuffers;
+        buffers.undoLog.clear();
+        buffers.reserve(maxSimulationDepth);
+
         // Single-threaded MCTS with modern enhancements
         for (int iteration = 0; iteration < maxIterations && !shouldStop; ++iteration) {
             if (!shouldContinueSearch(startTime)) {
                 break;
             }
             
-            // Selection
-            MCTSNode* selectedNode = select(root.get());
+            // Selection, then rebuild the selected node's state on scratch
+            MCTSNode* selectedNode = select(root);
+            replayPathFromRoot(scratch, selectedNode, playerId, buffers.undoLog);
             
-            // Expansion
+            // Expansion (moves scratch on to the new child)
             MCTSNode* nodeToSimulate = selectedNode;
             if (!selectedNode->isTerminalNode()) {
-                MCTSNode* expandedNode = expand(selectedNode);
+                MCTSNode* expandedNode = expand(selectedNode, scratch, buffers.undoLog);
                 if (expandedNode != selectedNode) {
                     nodeToSimulate = expandedNode;
                     totalExpansions++;
@@ -347,32 +439,23 @@ MCTSResult MCTSEngine::findBestAction(const GameState& state, const std::string&
             }
             
             // Simulation with action sequence tracking
-            std::vector<BotAction> actionSequence;
-            double reward = simulate(nodeToSimulate->getGameState(), playerId, actionSequence);
+            double reward = simulate(scratch, playerId, buffers);
+            rewindScratch(scratch, buffers.undoLog, 0);
             totalSimulations++;
             
             // Backpropagation with AMAF update
-            backpropagate(nodeToSimulate, reward, actionSequence);
+            backpropagate(nodeToSimulate, reward, buffers.actionSequence);
         }
     } else {
-        // Multi-threaded MCTS with virtual loss
-        std::vector<std::future<void>> futures;
-        
-        for (int threadId = 0; threadId < numThreads; ++threadId) {
-            futures.push_back(std::async(std::launch::async, 
-                [this, &root, &playerId, threadId]() {
-                    runParallelMCTS(root.get(), playerId, threadId);
-                }));
-        }
-        
-        // Wait for time limit
-        std::this_thread::sleep_for(timeLimit);
-        shouldStop = true;
-        
-        // Wait for all threads to complete
-        for (auto& future : futures) {
-            future.wait();
+        // Multi-threaded MCTS with virtual loss on the persistent pool. Every
+        // participant (this thread included) stops at the deadline or iteration cap.
+        if (!threadPool || threadPool->concurrency() != numThreads) {
+            ownedThreadPool = std::make_unique<SearchThreadPool>(numThreads);
+            threadPool = ownedThreadPool.get();
         }
+        threadPool->run([this, root, playerId, startTime](int) {
+            runParallelMCTS(root, playerId, startTime);
+        });
     }
 
 #ifdef ENABLE_MCTS_DEBUG
@@ -385,39 +468,48 @@ MCTSResult MCTSEngine::findBestAction(const GameState& state, const std::string&
         fmt::println("Transposition Table Size: {}", transpositionTable->size());
     }
     fmt::println("{:<12} | {:>10} | {:>15} | {:>15} | {:>15}", 
-                 "Action", "Visits", "Avg Reward", "UCB Value", "AMAF Value");
+                 "Action", "Visits", "Avg Reward", "UCB Value", "RAVE Value");
     
     for (const auto& child : root->getChildren()) {
         double ucbValue = banditAlgorithm ? 
-            banditAlgorithm->calculateValue(child.get(), root.get()) :
-            calculateUCB1(child.get(), root.get());
-        double amafValue = useAMAF ? amaf->getAMAFValue(child->getAction()) : 0.0;
+            banditAlgorithm->calculateValue(child, root) :
+            calculateUCB1(child, root);
+        double raveValue = root->getRAVEValue(child->getAction());
         
         fmt::println("{:<12} | {:>10} | {:>15.4f} | {:>15.4f} | {:>15.4f}", 
                      static_cast<int>(child->getAction()),
                      child->getVisits(), 
                      child->getAverageReward(),
                      ucbValue,
-                     amafValue);
+                     raveValue);
     }
 #endif
 
     MCTSResult result;
     result.bestAction = BotAction::None;
 
-    // Select the child with the highest visit count (robust measure)
+    // Select the child with the highest visit count (robust measure), never
+    // a proven loss while another move is still open
     MCTSNode* bestChild = nullptr;
     int bestVisits = -1;
+    bool bestLost = true;
 
     for (const auto& child : root->getChildren()) {
         int visits = child->getVisits();
-        if (visits > bestVisits) {
+        bool lost = child->isProvenLoss();
+        if (!bestChild || (bestLost && !lost)) {
             bestVisits = visits;
-            bestChild = child.get();
-        } else if (visits == bestVisits && bestChild != nullptr) {
-            // Tie-break: higher average reward
-            if (child->getAverageReward() > bestChild->getAverageReward()) {
-                bestChild = child.get();
+            bestChild = child;
+            bestLost = lost;
+        } else if (lost == bestLost) {
+            if (visits > bestVisits) {
+                bestVisits = visits;
+                bestChild = child;
+            } else if (visits == bestVisits) {
+                // Tie-break: higher average reward
+                if (child->getAverageReward() > bestChild->getAverageReward()) {
+                    bestChild = child;
+                }
             }
         }
 
@@ -436,6 +528,10 @@ MCTSResult MCTSEngine::findBestAction(const GameState& state, const std::string&
         }
     }
 
+    // Keep the tree: next tick resumes from the child we are about to play
+    previousRoot = root;
+    previousAction = result.bestAction;
+
     return result;
 }
 
@@ -445,38 +541,53 @@ MCTSNode* MCTSEngine::select(MCTSNode* root) {
     while (!current->isTerminalNode() && current->isFullyExpandedNode()) {
         constexpr double EPS = 1e-9;
         double bestValue = -std::numeric_limits<double>::infinity();
-        std::vector<MCTSNode*> bestChildren;
+        MCTSNode::ChildList bestChildren;
+        const MCTSNode::ChildList& children = current->getChildren();
 
-        for (const auto& child : current->getChildren()) {
-            double value;
-            
-            if (banditAlgorithm) {
-                // Use the configured bandit algorithm
-                value = banditAlgorithm->calculateValue(child.get(), current);
-            } else {
-                // Fallback to standard UCB1
-                value = calculateUCB1(child.get(), current);
+        // One load of the children's contiguous statistics, then one pass of
+        // the bandit formula over all of them
+        MCTSNode::ChildStatistics stats;
+        current->loadChildStatistics(stats);
+        std::array<double, BOT_ACTION_COUNT> values;
+        if (banditAlgorithm) {
+            banditAlgorithm->calculateValues(stats, current->getVisits(), values.data());
+        } else {
+            // Fallback to standard UCB1, which needs each child's state
+            for (size_t i = 0; i < stats.count; ++i) {
+                values[i] = calculateUCB1(children[i], current);
+            }
+        }
+
+        for (size_t i = 0; i < stats.count; ++i) {
+            // Proven losses have nothing left to learn; if every child is one,
+            // this node is itself proven and selection stops here
+            if ((stats.provenLoss >> i) & 1u) {
+                continue;
             }
             
-            // Apply AMAF if enabled
-            if (useAMAF) {
-                double mctsValue = child->getAverageReward();
-                double combinedValue = amaf->combinedValue(mctsValue, child->getAction(), child->getVisits());
-                value = 0.7 * value + 0.3 * combinedValue; // Weighted combination
+            double value = values[i];
+            
+            // RAVE: move the child's mean towards its action's AMAF mean here,
+            // by a weight that fades as the child's own visits grow
+            if (useRAVE && stats.raveVisits[i] > 0) {
+                double beta = std::sqrt(RAVE_EQUIVALENCE / (3.0 * stats.visits[i] + RAVE_EQUIVALENCE));
+                value += beta * (stats.raveMeanReward[i] - stats.meanReward[i]);
             }
             
+            // Progressive bias: the stored heuristic prior, fading as real visits accumulate
+            value += heuristicWeight * PROGRESSIVE_BIAS_SCALE * stats.prior[i] / (1.0 + stats.visits[i]);
+            
             // Apply virtual loss if enabled (for multi-threading)
             if (useVirtualLoss && numThreads > 1) {
-                double virtualLossValue = virtualLoss->getVirtualLoss(child.get());
-                value -= virtualLossValue;
+                value -= stats.virtualLoss[i] * virtualLossValue;
             }
             
             if (value > bestValue + EPS) {
                 bestValue = value;
                 bestChildren.clear();
-                bestChildren.push_back(child.get());
+                bestChildren.push_back(children[i]);
             } else if (std::abs(value - bestValue) <= EPS) {
-                bestChildren.push_back(child.get());
+                bestChildren.push_back(children[i]);
             }
         }
 
@@ -490,75 +601,93 @@ MCTSNode* MCTSEngine::select(MCTSNode* root) {
         
         // Apply virtual loss to selected node
         if (useVirtualLoss && numThreads > 1) {
-            virtualLoss->addVirtualLoss(current);
+            current->addVirtualLoss();
         }
     }
     
     return current;
 }
 
-MCTSNode* MCTSEngine::expand(MCTSNode* node) {
+MCTSNode* MCTSEngine::expand(MCTSNode* node, GameState& state, std::vector<StateDelta>& undoLog) {
     if (node->isTerminalNode() || node->isFullyExpandedNode()) {
         return node;
     }
     
-    std::lock_guard<std::mutex> lock(treeMutex);
-    
-    // Double-check after acquiring lock
-    if (node->isFullyExpandedNode()) {
+    // Claim the node; if another thread is already expanding it, leave it alone
+    if (!node->tryLockExpansion()) {
         return node;
     }
     
-    // Check transposition table first
-    if (useTranspositionTable) {
-        std::string stateHash = hashGameState(node->getGameState(), node->getPlayerId());
-        auto existingNode = transpositionTable->lookup(stateHash);
-        if (existingNode && existingNode.get() != node) {
-            // Found an existing equivalent state - merge statistics
-            // Simple merging: combine visit counts and average rewards
-            int existingVisits = existingNode->getVisits();
-            double existingReward = existingNode->getAverageReward();
-            int currentVisits = node->getVisits();
-            double currentReward = node->getAverageReward();
-            
-            if (existingVisits > 0 && currentVisits > 0) {
-                // Weighted average of rewards
-                double combinedReward = (existingReward * existingVisits + currentReward * currentVisits) / 
-                                       (existingVisits + currentVisits);
-                // Update the existing node with combined statistics
-                existingNode->update(combinedReward * (existingVisits + currentVisits) - existingNode->getTotalReward());
-            }
-            
-            return existingNode.get();
-        }
+    // Score all of the node's actions once, before its first child appears
+    if (!node->hasActionPriors() && node->getChildren().empty()) {
+        node->setActionPriors(computeActionPriors(state, node->getPlayerId()));
     }
     
-    // Use the existing expand method
-    MCTSNode* expandedNode = node->expand();
+    // Use the existing expand method; from here on state is the new child's
+    MCTSNode* expandedNode = node->expand(*nodePool, state, undoLog);
     
-    // Store in transposition table if new node was created
+    // A new child whose state was already reached through another path starts
+    // from that path's statistics, capped so it stays a prior rather than a verdict
     if (expandedNode && expandedNode != node && useTranspositionTable) {
-        std::string stateHash = hashGameState(expandedNode->getGameState(), expandedNode->getPlayerId());
-        // Create a shared_ptr wrapper for the transposition table
-        // Note: This is a simplified implementation - proper integration would require
-        // redesigning the node ownership model
-        std::shared_ptr<MCTSNode> sharedNode(expandedNode, [](MCTSNode*) {
-            // Custom deleter that does nothing - the unique_ptr in the tree will handle deletion
-        });
-        transpositionTable->store(stateHash, sharedNode);
+        TranspositionTable::Entry entry;
+        uint64_t key = transpositionKey(expandedNode->getStateHash(), expandedNode->getPlayerId());
+        if (transpositionTable->lookup(key, entry)) {
+            expandedNode->seedStatistics(std::min(entry.visits, TRANSPOSITION_PRIOR_VISITS), entry.avgReward);
+        }
+    }
+    
+    // MCTS-Solver: the move walks into a certain capture, so the child (and
+    // any ancestor this leaves without another move) is a proven loss
+    if (expandedNode && expandedNode != node &&
+        state.isPlayerCaught(expandedNode->getPlayerId())) {
+        expandedNode->markProvenLoss();
     }
     
+    node->unlockExpansion();
     return expandedNode;
 }
 
-double MCTSEngine::simulate(const GameState& state, const std::string& playerId, std::vector<BotAction>& actionSequence) {
-    GameState simState = state;
+void MCTSEngine::replayPathFromRoot(GameState& scratch, const MCTSNode* node, AnimalHandle playerId,
+                                    std::vector<StateDelta>& undoLog) const {
+    if (!node->getParent()) return;
+    replayPathFromRoot(scratch, node->getParent(), playerId, undoLog);
+    undoLog.emplace_back();
+    scratch.applyAction(playerId, node->getAction(), undoLog.back());
+}
+
+double MCTSEngine::playRollouts(const GameState& state, AnimalHandle playerId, int count) {
+    GameState scratch = state;
+    rolloutBuffers.undoLog.clear();
+    rolloutBuffers.reserve(maxSimulationDepth);
+    double total = 0.0;
+    for (int i = 0; i < count; ++i) {
+        total += simulate(scratch, playerId, rolloutBuffers);
+        rewindScratch(scratch, rolloutBuffers.undoLog, 0);
+    }
+    return count > 0 ? total / count : 0.0;
+}
+
+void MCTSEngine::rewindScratch(GameState& scratch, std::vector<StateDelta>& undoLog, size_t mark) const {
+    while (undoLog.size() > mark) {
+        scratch.undo(undoLog.back());
+        undoLog.pop_back();
+    }
+}
+
+double MCTSEngine::simulate(GameState& simState, AnimalHandle playerId, RolloutBuffers& buffers) {
+    // Every step is recorded so the scratch state is handed back unchanged
+    std::vector<StateDelta>& undoLog = buffers.undoLog;
+    std::vector<BotAction>& actionSequence = buffers.actionSequence;
+    actionSequence.clear();
+    const size_t rolloutStart = undoLog.size();
     int depth = 0;
     double cumulativeReward = 0.0;
     double decayFactor = 0.95; // Decay factor for future rewards
     
-    // Cycle detection: track visited state hashes
-    std::unordered_set<std::string> visitedStates;
+    // Cycle detection: Zobrist keys of the states this rollout has passed
+    // through, in a ring on the stack; a linear scan of a few cache lines
+    std::array<uint64_t, CYCLE_WINDOW> recentKeys;
+    int keyCount = 0;
     int cycleDetectionPenalty = 0;
     
     while (!simState.isTerminal() && depth < maxSimulationDepth) {
@@ -573,17 +702,20 @@ double MCTSEngine::simulate(const GameState& state, const std::string& playerId,
         int scoreBeforeAction = currentAnimal->score;
         
         BotAction action = selectSimulationAction(simState, playerId);
-        simState.applyAction(playerId, action);
+        undoLog.emplace_back();
+        StateDelta& delta = undoLog.back();
+        simState.applyAction(playerId, action, delta);
 
         // Cycle detection: check if we've seen this state before
-        std::string stateHash = hashGameState(simState, playerId);
-        if (visitedStates.find(stateHash) != visitedStates.end()) {
+        uint64_t stateHash = simState.hash();
+        auto recentEnd = recentKeys.begin() + std::min(keyCount, CYCLE_WINDOW);
+        if (std::find(recentKeys.begin(), recentEnd, stateHash) != recentEnd) {
             // Apply moderate penalty for revisiting state but continue rollout
             cumulativeReward -= 100.0 * std::pow(decayFactor, depth);
             cycleDetectionPenalty++;
             if (cycleDetectionPenalty > 3) break; // Only terminate after multiple cycles
         }
-        visitedStates.insert(stateHash);
+        recentKeys[keyCount++ % CYCLE_WINDOW] = stateHash;
 
         // Calculate immediate reward for this step
         const Animal* newAnimal = simState.getAnimal(playerId);
@@ -596,10 +728,10 @@ double MCTSEngine::simulate(const GameState& state, const std::string& playerId,
             }
             
             // Exploration reward for visiting new cells
-            if (simState.visitedCells.find(newAnimal->position) == simState.visitedCells.end()) {
+            if (!simState.isVisited(newAnimal->position)) {
                 double explorationReward = 20.0; // Increased reward for exploration
                 cumulativeReward += explorationReward * std::pow(decayFactor, depth);
-                simState.visitedCells.insert(newAnimal->position);
+                simState.markVisited(newAnimal->position, delta);
             } else {
                 // Penalty for revisiting cells
                 double revisitPenalty = 10.0;
@@ -607,16 +739,8 @@ double MCTSEngine::simulate(const GameState& state, const std::string& playerId,
             }
         }
 
-        // --- Simulate zookeeper movement (greedy one-step towards target) ---
-        for (auto& zk : simState.zookeepers) {
-            Position nextPos = simState.predictZookeeperPosition(zk, 1);
-            zk.position = nextPos;
-            // Capture check – if zookeeper ends on the same cell as the player, mark caught
-            Animal* myAnimal = simState.getAnimal(playerId);
-            if (myAnimal && myAnimal->position == zk.position) {
-                myAnimal->isCaught = true;
-            }
-        }
+        // Zookeepers already took their chase step (and any capture) inside
+        // applyAction, so a rollout tick moves them exactly once
         
         // Apply penalty if captured but continue rollout to learn recovery
         if (simState.isPlayerCaught(playerId)) {
@@ -630,6 +754,7 @@ double MCTSEngine::simulate(const GameState& state, const std::string& playerId,
     
     // Combine cumulative step rewards with final state evaluation
     double terminalReward = evaluateTerminalState(simState, playerId);
+    rewindScratch(simState, undoLog, rolloutStart);
     
     // Apply additional penalty for cycle detection
     double cyclePenalty = cycleDetectionPenalty * 1000.0;
@@ -640,18 +765,32 @@ double MCTSEngine::simulate(const GameState& state, const std::string& playerId,
 void MCTSEngine::backpropagate(MCTSNode* node, double reward, const std::vector<BotAction>& actionSequence) {
     MCTSNode* current = node;
     
+    // Actions played after the current node, in the rollout or further down
+    // the path, as a BotAction bitmask: each counts once per simulation
+    uint32_t laterActions = 0;
+    if (useRAVE) {
+        for (BotAction action : actionSequence) {
+            laterActions |= 1u << static_cast<int>(action);
+        }
+    }
+    
     while (current != nullptr) {
         current->update(reward);
+        for (uint32_t mask = laterActions; mask != 0; mask &= mask - 1) {
+            current->updateRAVE(static_cast<BotAction>(BitOps::ctz(mask)), reward);
+        }
+        if (useTranspositionTable) {
+            transpositionTable->store(transpositionKey(current->getStateHash(), current->getPlayerId()),
+                                      current->getVisits(), current->getAverageReward());
+        }
+        if (useRAVE) {
+            laterActions |= 1u << static_cast<int>(current->getAction());
+        }
         current = current->getParent();
         
         // Alternate reward for opponent modeling (if needed)
         // reward = -reward;
     }
-
-    // Update AMAF
-    if (useAMAF) {
-        amaf->updateAMAF(actionSequence, reward);
-    }
 }
 
 double MCTSEngine::calculateUCB1(const MCTSNode* node, const MCTSNode* parent) const {
@@ -659,49 +798,35 @@ double MCTSEngine::calculateUCB1(const MCTSNode* node, const MCTSNode* parent) c
         return std::numeric_limits<double>::infinity(); // Prioritize unvisited nodes
     }
 
-    // Enhanced UCB1 with strong progressive bias toward pellet collection
-    const GameState& childState = node->getGameState();
-    const Animal* childAnimal = childState.getAnimal(childState.myAnimalId);
-    double heuristicBias = 0.0;
-    if (childAnimal) {
-        int dist = childState.distanceToNearestPellet(childAnimal->position);
-        if (dist >= 0) {
-            if (dist == 0) {
-                heuristicBias = 10.0; // HUGE bias for moves that collect pellets
-            } else if (dist == 1) {
-                heuristicBias = 5.0; // Strong bias for moves toward pellets
-            } else {
-                heuristicBias = 2.0 / dist; // Good bias for getting closer
-            }
-        }
-        
-        // Additional bias for maintaining streaks
-        if (childAnimal->ticksSinceLastPellet >= 3) {
-            heuristicBias *= 2.0; // Double bias when streak is at risk
-        }
-        
-        // Check if move leads to immediate pellet collection
-        CellContent cellAtPos = childState.getCell(childAnimal->position.x, childAnimal->position.y);
-        if (cellAtPos == CellContent::Pellet) {
-            heuristicBias += 15.0; // Massive bias for pellet collection moves
-        } else if (cellAtPos == CellContent::PowerPellet) {
-            heuristicBias += 25.0; // Even bigger bias for power pellets
-        }
-    }
-    // Progressive bias that decays more slowly for important moves
-    const double biasWeight = 8.0; // Much stronger bias weight
-    double progressiveBias = biasWeight * heuristicBias / (1.0 + std::pow(node->getVisits(), 0.5));
-
+    // Plain UCB1; select() adds the progressive bias from the child's stored prior
     double exploitation = node->getAverageReward();
     double exploration = explorationConstant * std::sqrt(std::log(parent->getVisits()) / node->getVisits());
     
-    return exploitation + exploration + progressiveBias;
+    return exploitation + exploration;
 }
 
-double MCTSEngine::calculateRAVE(const MCTSNode* node) const {
-    // RAVE implementation would go here
-    // For now, return 0 as it's not fully implemented
-    return 0.0;
+std::array<double, BOT_ACTION_COUNT> MCTSEngine::computeActionPriors(const GameState& state, AnimalHandle playerId) const {
+    std::array<double, BOT_ACTION_COUNT> priors{};
+    ActionList legalActions = state.getLegalActions(playerId);
+    if (legalActions.empty()) {
+        return priors;
+    }
+    
+    ActionScores scores = heuristicsEngine.evaluateAllActions(state, playerId);
+    
+    double lowest = std::numeric_limits<double>::infinity();
+    double highest = -std::numeric_limits<double>::infinity();
+    for (BotAction action : legalActions) {
+        lowest = std::min(lowest, scores[static_cast<int>(action)]);
+        highest = std::max(highest, scores[static_cast<int>(action)]);
+    }
+    
+    // Heuristic totals have no fixed scale, so only their order among siblings counts
+    for (BotAction action : legalActions) {
+        int index = static_cast<int>(action);
+        priors[index] = highest > lowest ? (scores[index] - lowest) / (highest - lowest) : 0.5;
+    }
+    return priors;
 }
 
 bool MCTSEngine::shouldExpandNode(const MCTSNode* node) const {
@@ -713,7 +838,7 @@ bool MCTSEngine::shouldExpandNode(const MCTSNode* node) const {
     return std::pow(visits, alpha) > children;
 }
 
-BotAction MCTSEngine::selectSimulationAction(const GameState& state, const std::string& playerId) {
+BotAction MCTSEngine::selectSimulationAction(const GameState& state, AnimalHandle playerId) {
     auto legalActions = state.getLegalActions(playerId);
     if (legalActions.empty()) {
         return BotAction::Up;
@@ -784,7 +909,7 @@ BotAction MCTSEngine::selectSimulationAction(const GameState& state, const std::
     return bestAction;
 }
 
-double MCTSEngine::evaluateTerminalState(const GameState& state, const std::string& playerId) {
+double MCTSEngine::evaluateTerminalState(const GameState& state, AnimalHandle playerId) {
     const Animal* animal = state.getAnimal(playerId);
     if (!animal) {
         return 0.0; // Should not happen
@@ -864,31 +989,26 @@ double MCTSEngine::evaluateTerminalState(const GameState& state, const std::stri
 
     // 8. Check proximity to power-ups
     double powerUpProximity = 0.0;
-    for (int dx = -3; dx <= 3; ++dx) {
-        for (int dy = -3; dy <= 3; ++dy) {
-            int x = animal->position.x + dx;
-            int y = animal->position.y + dy;
-            if (x >= 0 && x < state.getWidth() && y >= 0 && y < state.getHeight()) {
-                CellContent content = state.getCell(x, y);
-                int distance = std::abs(dx) + std::abs(dy);
-                if (distance > 0) {
-                    if (content == CellContent::Scavenger) {
-                        powerUpProximity += 20.0 / distance;
-                    } else if (content == CellContent::ChameleonCloak && currentThreat > 2.0) {
-                        powerUpProximity += 15.0 / distance;
-                    } else if (content == CellContent::BigMooseJuice && currentThreat > 1.0) {
-                        powerUpProximity += 10.0 / distance;
-                    }
-                }
+    const Position& here = animal->position;
+    state.getPowerUpBoard().forEachInRect(here.x - 3, here.y - 3, here.x + 3, here.y + 3, [&](int x, int y) {
+        CellContent content = state.getCell(x, y);
+        int distance = std::abs(x - here.x) + std::abs(y - here.y);
+        if (distance > 0) {
+            if (content == CellContent::Scavenger) {
+                powerUpProximity += 20.0 / distance;
+            } else if (content == CellContent::ChameleonCloak && currentThreat > 2.0) {
+                powerUpProximity += 15.0 / distance;
+            } else if (content == CellContent::BigMooseJuice && currentThreat > 1.0) {
+                powerUpProximity += 10.0 / distance;
             }
         }
-    }
+    });
 
     // 9. Exploration reward and penalty for repeated cell visits
     double explorationScore = 0.0;
-    if (state.visitedCells.size() > 0) {
+    if (state.getVisitedCount() > 0) {
         int totalCells = state.getWidth() * state.getHeight();
-        int visitedCells = static_cast<int>(state.visitedCells.size());
+        int visitedCells = state.getVisitedCount();
         double explorationRatio = static_cast<double>(visitedCells) / totalCells;
         
         // Reward good exploration ratios
@@ -909,41 +1029,45 @@ double MCTSEngine::evaluateTerminalState(const GameState& state, const std::stri
     return finalScore;
 }
 
-void MCTSEngine::runParallelMCTS(MCTSNode* root, const std::string& playerId, int threadId) {
-    std::mt19937 localRng(static_cast<unsigned int>(std::chrono::steady_clock::now().time_since_epoch().count() + threadId));
+void MCTSEngine::runParallelMCTS(MCTSNode* root, AnimalHandle playerId,
+                                 std::chrono::steady_clock::time_point startTime) {
+    GameState scratch = root->getGameState();
+    RolloutBuffers buffers;
+    buffers.reserve(maxSimulationDepth);
     
     while (!shouldStop.load()) {
-        // Selection with virtual loss
+        if (!shouldContinueSearch(startTime) || totalSimulations.load() >= maxIterations) {
+            shouldStop = true;
+            break;
+        }
+        
+        // Selection with virtual loss, then rebuild the selected node's state on scratch
         MCTSNode* selectedNode = select(root);
+        replayPathFromRoot(scratch, selectedNode, playerId, buffers.undoLog);
         
-        // Expansion
+        // Expansion (a node being expanded by another thread is simulated as is)
         MCTSNode* nodeToSimulate = selectedNode;
         if (!selectedNode->isTerminalNode()) {
-            if (selectedNode->tryLockExpansion()) {
-                if (!selectedNode->isFullyExpandedNode()) { // Double check after lock
-                    MCTSNode* expandedNode = expand(selectedNode);
-                    if (expandedNode != selectedNode) { // Check if a *new* node was created
-                        nodeToSimulate = expandedNode;
-                        totalExpansions++;
-                    }
-                }
-                selectedNode->unlockExpansion();
+            MCTSNode* expandedNode = expand(selectedNode, scratch, buffers.undoLog);
+            if (expandedNode != selectedNode) { // Check if a *new* node was created
+                nodeToSimulate = expandedNode;
+                totalExpansions++;
             }
         }
         
         // Simulation with action sequence tracking
-        std::vector<BotAction> actionSequence;
-        double reward = simulate(nodeToSimulate->getGameState(), playerId, actionSequence);
+        double reward = simulate(scratch, playerId, buffers);
+        rewindScratch(scratch, buffers.undoLog, 0);
         totalSimulations++;
         
         // Backpropagation with AMAF update
-        backpropagate(nodeToSimulate, reward, actionSequence);
+        backpropagate(nodeToSimulate, reward, buffers.actionSequence);
         
-        // Remove virtual loss from the path
+        // Remove the virtual loss select() put on the path (the new child never had any)
         if (useVirtualLoss) {
-            MCTSNode* current = nodeToSimulate;
+            MCTSNode* current = selectedNode;
             while (current && current != root) {
-                virtualLoss->removeVirtualLoss(current);
+                current->removeVirtualLoss();
                 current = current->getParent();
             }
         }
@@ -954,10 +1078,6 @@ void MCTSEngine::enableProgressiveWidening(bool enable) {
     // Implementation for enabling/disabling progressive widening
 }
 
-void MCTSEngine::enableRAVE(bool enable) {
-    // Implementation for enabling/disabling RAVE
-}
-
 void MCTSEngine::setHeuristicWeight(double weight) {
-    // Implementation for setting heuristic weight in simulations
+    heuristicWeight = weight;
 }
\ No newline at end of file
@@ -3,6 +3,7 @@
 #include "GameState.h"
 #include "MCTSNode.h"
 #include "Heuristics.h"
+#include "SearchThreadPool.h"
 
 struct ActionStats {
     BotAction action;
@@ -20,65 +21,52 @@ struct MCTSResult {
 #include <chrono>
 #include <thread>
 #include <atomic>
-#include <mutex>
+#include <array>
 #include <random>
 #include <unordered_map>
 
 // Modern MCTS enhancement classes
+
+// Fixed-size, lock-free transposition table keyed by GameState::hash().
+// Slots are written as (key ^ data, data) with relaxed stores, so an entry torn
+// by two concurrent writers fails the key check and reads as a miss.
+// Each store is stamped with the search generation; when a bucket is full the
+// victim is a slot from an older search first, then the least-visited one.
 class TranspositionTable {
-private:
-    struct StateEntry {
-        std::string stateHash;
-        std::weak_ptr<MCTSNode> node;
-        int visits;
-        double avgReward;
-        std::chrono::steady_clock::time_point lastAccessed;
-    };
-    
-    std::unordered_map<std::string, StateEntry> table;
-    std::mutex tableMutex;
-    size_t maxSize;
-    
 public:
-    TranspositionTable(size_t maxSize = 100000) : maxSize(maxSize) {}
-    
-    std::shared_ptr<MCTSNode> lookup(const std::string& stateHash);
-    void store(const std::string& stateHash, std::shared_ptr<MCTSNode> node);
-    void cleanup(); // Remove expired weak_ptrs
-    size_t size() const { return table.size(); }
-};
+    struct Entry {
+        int visits = 0;
+        double avgReward = 0.0;
+    };
 
-class VirtualLoss {
 private:
-    std::unordered_map<MCTSNode*, std::atomic<double>> virtualLosses;
-    mutable std::mutex lossMapMutex;
-    double virtualLossValue;
+    struct Slot {
+        std::atomic<uint64_t> check{0};
+        std::atomic<uint64_t> data{0};
+    };
     
-public:
-    VirtualLoss(double lossValue = 10.0) : virtualLossValue(lossValue) {}
+    static constexpr size_t BUCKET_SIZE = 4;
+    static constexpr int MAX_VISITS = (1 << 24) - 1;
     
-    void addVirtualLoss(MCTSNode* node);
-    void removeVirtualLoss(MCTSNode* node);
-    double getVirtualLoss(MCTSNode* node) const;
-};
-
-class AMAF {
-private:
-    struct AMAFStats {
-        std::atomic<double> totalReward{0.0};
-        std::atomic<int> visits{0};
-    };
+    std::unique_ptr<Slot[]> slots;
+    size_t bucketMask;
+    std::atomic<uint8_t> generation{1};
     
-    std::unordered_map<BotAction, AMAFStats> globalStats;
-    mutable std::mutex statsMutex;
-    double beta;
+    static uint64_t pack(int visits, double avgReward, uint8_t gen);
+    static Entry unpack(uint64_t data);
+    static uint8_t generationOf(uint64_t data) { return static_cast<uint8_t>(data >> 24); }
     
 public:
-    AMAF(double beta = 0.25) : beta(beta) {}
-    
-    void updateAMAF(const std::vector<BotAction>& sequence, double finalReward);
-    double getAMAFValue(BotAction action) const;
-    double combinedValue(double mctsValue, BotAction action, int mctsVisits) const;
+    // capacity is rounded up to a power-of-two number of buckets
+    explicit TranspositionTable(size_t capacity = 1 << 16);
+    
+    bool lookup(uint64_t key, Entry& entry) const;
+    void store(uint64_t key, int visits, double avgReward);
+    // Marks everything stored so far as replaceable; call once per search
+    void newGeneration();
+    void clear();
+    size_t capacity() const { return (bucketMask + 1) * BUCKET_SIZE; }
+    size_t size() const; // O(capacity), for diagnostics
 };
 
 // Enhanced bandit algorithms
@@ -86,6 +74,12 @@ class BanditAlgorithm {
 public:
     virtual ~BanditAlgorithm() = default;
     virtual double calculateValue(const MCTSNode* node, const MCTSNode* parent) const = 0;
+    // Values for all of a parent's children in one pass over their statistics
+    // (values has BOT_ACTION_COUNT entries; unvisited children get +infinity).
+    // log(parentVisits) is taken once and every lane runs the same branch-free
+    // arithmetic, so the loop compiles to straight-line, vectorisable code.
+    virtual void calculateValues(const MCTSNode::ChildStatistics& children, int parentVisits,
+                                 double* values) const = 0;
     virtual std::string getName() const = 0;
 };
 
@@ -99,6 +93,8 @@ public:
         : explorationConstant(c), progressiveBiasWeight(biasWeight) {}
     
     double calculateValue(const MCTSNode* node, const MCTSNode* parent) const override;
+    void calculateValues(const MCTSNode::ChildStatistics& children, int parentVisits,
+                         double* values) const override;
     std::string getName() const override { return "Enhanced UCB1"; }
 };
 
@@ -112,6 +108,8 @@ public:
         : explorationConstant(c), varianceScale(varScale) {}
     
     double calculateValue(const MCTSNode* node, const MCTSNode* parent) const override;
+    void calculateValues(const MCTSNode::ChildStatistics& children, int parentVisits,
+                         double* values) const override;
     std::string getName() const override { return "UCB-V"; }
 };
 
@@ -123,16 +121,40 @@ private:
     int maxSimulationDepth;
     std::chrono::milliseconds timeLimit;
     
-    // Threading
+    // Threading: the tree is shared without locks. Expansion is claimed per node
+    // (MCTSNode::tryLockExpansion) and virtual loss lives in the nodes themselves.
     int numThreads;
     std::atomic<bool> shouldStop;
-    std::mutex treeMutex;
+    double virtualLossValue;
+    // Search threads: normally MctsService's pool; created on demand otherwise
+    SearchThreadPool* threadPool = nullptr;
+    std::unique_ptr<SearchThreadPool> ownedThreadPool;
     
     // Random number generation
     thread_local static std::mt19937 rng;
     
-    // Heuristics
+    // Heuristics, evaluated once per expanded node to give its actions a prior.
+    // Evaluation is a pure function of the state, so all threads share it.
     HeuristicsEngine heuristicsEngine;
+    // Selection bonus for a prior of 1 on an unvisited child (about ten
+    // pellets of rollout reward), decaying with 1 / (1 + visits)
+    static constexpr double PROGRESSIVE_BIAS_SCALE = 1000.0;
+    
+    // Storage for the search tree. The tree outlives a search so the next tick
+    // can continue from the subtree of the action we played; sparePool is the
+    // compaction target once discarded siblings take up too much of nodePool.
+    std::unique_ptr<NodePool> nodePool;
+    std::unique_ptr<NodePool> sparePool;
+    MCTSNode* previousRoot = nullptr;
+    BotAction previousAction = BotAction::None;
+    bool useTreeReuse = true;
+    int lastReusedVisits = 0;
+    static constexpr size_t COMPACTION_THRESHOLD = 100000;
+    // Static layout of the current map, built once per game; every state in
+    // the tree points at it. Null while searching an open grid.
+    std::shared_ptr<const MapTopology> topology;
+    int mapWidth = 0;
+    int mapHeight = 0;
     
     // Statistics
     mutable std::atomic<int> totalSimulations;
@@ -140,49 +162,88 @@ private:
     
     // Modern MCTS enhancements
     std::unique_ptr<TranspositionTable> transpositionTable;
-    std::unique_ptr<VirtualLoss> virtualLoss;
-    std::unique_ptr<AMAF> amaf;
     std::unique_ptr<BanditAlgorithm> banditAlgorithm;
     
     // Configuration flags
     bool useTranspositionTable;
     bool useVirtualLoss;
-    bool useAMAF;
     bool useProgressiveWidening;
     bool useRAVE;
     double heuristicWeight;
+    // Child visits at which RAVE and the child's own mean weigh equally, in
+    // the schedule beta = sqrt(k / (3n + k))
+    static constexpr double RAVE_EQUIVALENCE = 250.0;
     
     // Move ordering
     std::vector<BotAction> moveOrdering;
     
+    // Per-thread buffers reused by every iteration, so once they have grown to
+    // their working size the search loop no longer touches the heap
+    struct RolloutBuffers {
+        std::vector<StateDelta> undoLog;
+        std::vector<BotAction> actionSequence;
+        
+        void reserve(int depth) {
+            undoLog.reserve(depth + 64);
+            actionSequence.reserve(depth);
+        }
+    };
+    // The calling thread's buffers for single-threaded searches and
+    // playRollouts(), kept across calls
+    RolloutBuffers rolloutBuffers;
+    
+    // Rollout steps whose state keys are remembered for cycle detection; at
+    // search depths this covers the whole rollout
+    static constexpr int CYCLE_WINDOW = 64;
+    
     // MCTS phases
     MCTSNode* select(MCTSNode* root);
-    MCTSNode* expand(MCTSNode* node);
-    double simulate(const GameState& state, const std::string& playerId, std::vector<BotAction>& actionSequence);
+    // state must be node's state; it is moved on to the child that was added
+    MCTSNode* expand(MCTSNode* node, GameState& state, std::vector<StateDelta>& undoLog);
+    // Plays a rollout on state, logging every step to buffers.undoLog and the
+    // actions taken to buffers.actionSequence
+    double simulate(GameState& state, AnimalHandle playerId, RolloutBuffers& buffers);
     void backpropagate(MCTSNode* node, double reward, const std::vector<BotAction>& actionSequence);
     
     // Advanced MCTS techniques
     double calculateUCB1(const MCTSNode* node, const MCTSNode* parent) const;
-    double calculateRAVE(const MCTSNode* node) const;
     bool shouldExpandNode(const MCTSNode* node) const;
     
     // Simulation policies
-    BotAction selectSimulationAction(const GameState& state, const std::string& playerId);
-    double evaluateTerminalState(const GameState& state, const std::string& playerId);
+    BotAction selectSimulationAction(const GameState& state, AnimalHandle playerId);
+    double evaluateTerminalState(const GameState& state, AnimalHandle playerId);
+    
+    // Heuristic score of every legal action, min-max normalised to [0, 1]
+    std::array<double, BOT_ACTION_COUNT> computeActionPriors(const GameState& state, AnimalHandle playerId) const;
     
     // Move ordering and pruning
-    void initializeMoveOrdering(const GameState& state, const std::string& playerId);
-    std::vector<BotAction> getOrderedMoves(const GameState& state, const std::string& playerId);
-    bool shouldPruneMove(BotAction action, const GameState& state, const std::string& playerId);
+    void initializeMoveOrdering(const GameState& state, AnimalHandle playerId);
+    std::vector<BotAction> getOrderedMoves(const GameState& state, AnimalHandle playerId);
+    bool shouldPruneMove(BotAction action, const GameState& state, AnimalHandle playerId);
+    
+    static constexpr int TRANSPOSITION_PRIOR_VISITS = 8;
+    // Transposition table key: a node's state hash salted with the player
+    static uint64_t transpositionKey(uint64_t stateHash, AnimalHandle playerId);
     
-    // State hashing for transposition table
-    std::string hashGameState(const GameState& state, const std::string& playerId) const;
+    // Tree reuse: key over the parts of a state the search models, and the lookup
+    // of last tick's child that matches the observed state (nullptr if none)
+    uint64_t hashForReuse(const GameState& state, AnimalHandle playerId) const;
+    MCTSNode* reuseSubtree(const GameState& state, AnimalHandle playerId);
     
     // Helper method for position calculation
     Position getNewPosition(const Position& currentPos, BotAction action) const;
     
+    // Scratch-state management: tree nodes below the root keep no state, so
+    // each iteration replays the selected path onto a per-thread scratch state
+    // and rewinds it through the undo log instead of copying states.
+    // The replay walks parent links recursively instead of building a path.
+    void replayPathFromRoot(GameState& scratch, const MCTSNode* node, AnimalHandle playerId,
+                            std::vector<StateDelta>& undoLog) const;
+    void rewindScratch(GameState& scratch, std::vector<StateDelta>& undoLog, size_t mark) const;
+    
     // Threading support
-    void runParallelMCTS(MCTSNode* root, const std::string& playerId, int threadId);
+    void runParallelMCTS(MCTSNode* root, AnimalHandle playerId,
+                         std::chrono::steady_clock::time_point startTime);
     
     // Time management
     bool shouldContinueSearch(std::chrono::steady_clock::time_point startTime) const;
@@ -196,29 +257,44 @@ public:
     
     ~MCTSEngine();
     
-    // Main MCTS interface
-    MCTSResult findBestAction(const GameState& state, const std::string& playerId);
+    // Main MCTS interface. The time limit runs from startTime, so work done
+    // before the call (say, since the tick arrived) and any map set-up in it
+    // count against the same budget.
+    MCTSResult findBestAction(const GameState& state, AnimalHandle playerId,
+                              std::chrono::steady_clock::time_point startTime = std::chrono::steady_clock::now());
     
     // Configuration
     void setExplorationConstant(double c) { explorationConstant = c; }
     void setMaxIterations(int iterations) { maxIterations = iterations; }
     void setTimeLimit(int milliseconds) { timeLimit = std::chrono::milliseconds(milliseconds); }
     void setNumThreads(int threads) { numThreads = threads; }
+    // The pool must outlive the engine's searches and have numThreads participants
+    void setThreadPool(SearchThreadPool* pool) { threadPool = pool; }
     
     // Modern features configuration
     void enableTranspositionTable(bool enable) { useTranspositionTable = enable; }
     void enableVirtualLoss(bool enable) { useVirtualLoss = enable; }
-    void enableAMAF(bool enable) { useAMAF = enable; }
+    void enableTreeReuse(bool enable) { useTreeReuse = enable; }
     void setBanditAlgorithm(std::unique_ptr<BanditAlgorithm> algorithm) { banditAlgorithm = std::move(algorithm); }
     
     // Statistics
     int getTotalSimulations() const { return totalSimulations.load(); }
     int getTotalExpansions() const { return totalExpansions.load(); }
     void resetStatistics() { totalSimulations = 0; totalExpansions = 0; }
+    // Root visits inherited from the previous tick's tree by the last search
+    int getLastReusedVisits() const { return lastReusedVisits; }
+    // Root of the last search's tree; valid until the next findBestAction
+    const MCTSNode* getLastRoot() const { return previousRoot; }
+    // Plays count rollouts from state and returns their mean reward, on the
+    // same buffers as a single-threaded search: once warm, none allocates
+    double playRollouts(const GameState& state, AnimalHandle playerId, int count);
     
     // Advanced features
     void enableProgressiveWidening(bool enable);
-    void enableRAVE(bool enable);
+    // Per-node RAVE: blends each child's mean with the all-moves-as-first
+    // value of its action at the parent while the child has few visits
+    void enableRAVE(bool enable) { useRAVE = enable; }
+    // Strength of the heuristic progressive bias in selection (0 disables it)
     void setHeuristicWeight(double weight);
 };
 
@@ -231,20 +307,6 @@ public:
     static double calculate(const MCTSNode* node, const MCTSNode* parent, double explorationConstant);
 };
 
-// RAVE (Rapid Action Value Estimation) implementation
-class RAVE {
-private:
-    std::unordered_map<BotAction, std::pair<double, int>> actionValues;
-    double beta;
-    
-public:
-    RAVE(double beta = 0.5) : beta(beta) {}
-    
-    void updateActionValue(BotAction action, double reward);
-    double getActionValue(BotAction action) const;
-    double calculateRAVEValue(const MCTSNode* node) const;
-};
-
 // Progressive Widening implementation
 class ProgressiveWidening {
 private:
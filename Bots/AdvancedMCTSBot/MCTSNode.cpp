@@ -7,28 +7,47 @@
 #include <random> // Added for std::mt19937 and std::uniform_int_distribution
 #include <functional>
 
-MCTSNode::MCTSNode(std::unique_ptr<GameState> state, MCTSNode* parent, 
-                   BotAction action, const std::string& playerId)
-    : gameState(std::move(state))
+MCTSNode::MCTSNode(uint64_t stateHash, bool terminal, uint32_t legalActions, MCTSNode* parent,
+                   BotAction action, AnimalHandle playerId)
+    : gameState(nullptr)
+    , stateHash(stateHash)
     , parent(parent)
+    , slot(static_cast<uint8_t>(parent ? parent->children.size() : 0))
     , action(action)
     , playerId(playerId)
     , visits(0)
     , totalReward(0.0)
     , totalSquaredReward(0.0)
+    , provenLossChildren(0)
+    , untriedActions(terminal ? 0 : legalActions)
     , isExpanding(false)
     , isTerminal(false)
     , isFullyExpanded(false)
     , cachedUCBValue(0.0)
     , cachedUCBVisits(-1) {
     
-    isTerminal = gameState->isTerminal();
-    if (isTerminal.load()) {
+    for (int i = 0; i < BOT_ACTION_COUNT; ++i) {
+        raveRewards[i].store(0.0, std::memory_order_relaxed);
+        raveVisits[i].store(0, std::memory_order_relaxed);
+        childVisits[i].store(0, std::memory_order_relaxed);
+        childTotalReward[i].store(0.0, std::memory_order_relaxed);
+        childTotalSquaredReward[i].store(0.0, std::memory_order_relaxed);
+        childVirtualLoss[i].store(0, std::memory_order_relaxed);
+    }
+
+    isTerminal = terminal;
+    if (terminal) {
         isFullyExpanded = true;
     }
 }
 
-MCTSNode::~MCTSNode() = default;
+uint32_t MCTSNode::legalActionMask(const GameState& state, AnimalHandle playerId) {
+    uint32_t mask = 0;
+    for (BotAction action : state.getLegalActions(playerId)) {
+        mask |= 1u << static_cast<int>(action);
+    }
+    return mask;
+}
 
 MCTSNode* MCTSNode::select(double explorationConstant) {
     if (isTerminalNode() || !isFullyExpandedNode()) {
@@ -42,44 +61,56 @@ MCTSNode* MCTSNode::select(double explorationConstant) {
         double ucb = child->calculateUCB1Tuned(explorationConstant);
         if (ucb > bestUCB) {
             bestUCB = ucb;
-            bestChild = child.get();
+            bestChild = child;
         }
     }
     
     return bestChild ? bestChild->select(explorationConstant) : this;
 }
 
-MCTSNode* MCTSNode::expand() {
+MCTSNode* MCTSNode::expand(NodePool& pool, GameState& state, std::vector<StateDelta>& undoLog) {
     if (isTerminalNode() || isFullyExpandedNode()) {
         return this;
     }
     
-    auto untriedActions = getUntriedActions();
-    if (untriedActions.empty()) {
+    uint32_t untried = untriedActions.load(std::memory_order_relaxed);
+    if (untried == 0) {
         markAsFullyExpanded();
         return this;
     }
     
     // Select a random action to expand. This is crucial for exploring the tree.
     // Using a thread_local RNG here is efficient as it's initialized once per thread.
-        thread_local std::mt19937 generator(static_cast<unsigned int>(std::chrono::steady_clock::now().time_since_epoch().count()));
-    std::uniform_int_distribution<size_t> distribution(0, untriedActions.size() - 1);
-    BotAction actionToExpand = untriedActions[distribution(generator)];
-    
-    // Create a new state by cloning the current state and then applying the action
-    auto newState = gameState->clone();
-    newState->applyAction(this->playerId, actionToExpand);
-    auto child = std::make_unique<MCTSNode>(std::move(newState), this, actionToExpand, playerId);
-    MCTSNode* childPtr = child.get();
+    thread_local std::mt19937 generator(static_cast<unsigned int>(std::chrono::steady_clock::now().time_since_epoch().count()));
+    std::uniform_int_distribution<int> distribution(0, BitOps::popcount(untried) - 1);
+    uint32_t remaining = untried;
+    for (int skip = distribution(generator); skip > 0; --skip) {
+        remaining &= remaining - 1;
+    }
+    BotAction actionToExpand = static_cast<BotAction>(BitOps::ctz(remaining));
+    
+    // The child keeps only what selection and backpropagation need of its
+    // state, recorded while state stands for it; the state itself is replayed
+    undoLog.emplace_back();
+    state.applyAction(playerId, actionToExpand, undoLog.back());
+    MCTSNode* childPtr = pool.createNode(state.hash(), state.isTerminal(), legalActionMask(state, playerId),
+                                         this, actionToExpand, playerId);
+    if (!childPtr) {
+        // Pool exhausted: keep searching the existing tree
+        state.undo(undoLog.back());
+        undoLog.pop_back();
+        return this;
+    }
     
     // Note: Removed immediate reward shaping to prevent biasing tree before simulation
     // Let MCTS simulation and backpropagation handle reward evaluation naturally
 
-    children.push_back(std::move(child));
+    children.push_back(childPtr);
     
     // Check if fully expanded
-    auto allLegalActions = gameState->getLegalActions(playerId);
-    if (children.size() >= allLegalActions.size()) {
+    untried &= ~(1u << static_cast<int>(actionToExpand));
+    untriedActions.store(untried, std::memory_order_relaxed);
+    if (untried == 0) {
         markAsFullyExpanded();
     }
     
@@ -91,18 +122,27 @@ void MCTSNode::update(double reward) {
     atomicAddReward(reward);
     
     // Update squared reward for variance calculation
-    double currentSquaredReward = totalSquaredReward.load(std::memory_order_relaxed);
+    std::atomic<double>& squaredSum = squaredRewardSum();
+    double currentSquaredReward = squaredSum.load(std::memory_order_relaxed);
     double newSquaredReward;
     do {
         newSquaredReward = currentSquaredReward + (reward * reward);
-    } while (!totalSquaredReward.compare_exchange_weak(currentSquaredReward, newSquaredReward, std::memory_order_release, std::memory_order_relaxed));
+    } while (!squaredSum.compare_exchange_weak(currentSquaredReward, newSquaredReward, std::memory_order_release, std::memory_order_relaxed));
     
     // Invalidate cached UCB value
     cachedUCBVisits = -1;
 }
 
+void MCTSNode::seedStatistics(int seedVisits, double avgReward) {
+    if (seedVisits <= 0 || getVisits() != 0) return;
+    visitCounter() = seedVisits;
+    rewardSum() = avgReward * seedVisits;
+    squaredRewardSum() = avgReward * avgReward * seedVisits;
+    cachedUCBVisits = -1;
+}
+
 double MCTSNode::calculateUCB1(double explorationConstant) const {
-    if (visits.load() == 0) {
+    if (getVisits() == 0) {
         return std::numeric_limits<double>::infinity();
     }
     
@@ -112,13 +152,13 @@ double MCTSNode::calculateUCB1(double explorationConstant) const {
     
     double exploitation = getAverageReward();
     double exploration = explorationConstant * 
-                        std::sqrt(std::log(parent->getVisits()) / visits.load());
+                        std::sqrt(std::log(parent->getVisits()) / getVisits());
     
     return exploitation + exploration;
 }
 
 double MCTSNode::calculateUCB1Tuned(double explorationConstant) const {
-    if (visits.load() == 0) {
+    if (getVisits() == 0) {
         return std::numeric_limits<double>::infinity();
     }
     
@@ -127,7 +167,7 @@ double MCTSNode::calculateUCB1Tuned(double explorationConstant) const {
     }
     
     // Check if cached value is still valid
-    int currentVisits = visits.load();
+    int currentVisits = getVisits();
     if (cachedUCBVisits.load() == currentVisits) {
         return cachedUCBValue.load();
     }
@@ -151,50 +191,60 @@ double MCTSNode::calculateUCB1Tuned(double explorationConstant) const {
     return ucbValue;
 }
 
-double MCTSNode::calculateRAVEValue() const {
-    // RAVE implementation would combine MCTS and RAVE values
-    // For now, just return MCTS value
-    return getAverageReward();
-}
-
-bool MCTSNode::hasUntriedActions() const {
-    if (isTerminalNode()) return false;
-    
-    auto legalActions = gameState->getLegalActions(playerId);
-    return children.size() < legalActions.size();
-}
-
 double MCTSNode::getAverageReward() const {
-    int v = visits.load();
-    return v > 0 ? totalReward.load() / v : 0.0;
+    int v = getVisits();
+    return v > 0 ? rewardSum().load() / v : 0.0;
 }
 
 double MCTSNode::getRewardVariance() const {
-    int v = visits.load();
+    int v = getVisits();
     if (v <= 1) return 0.0;
     
     double mean = getAverageReward();
-    double meanSquared = totalSquaredReward.load() / v;
+    double meanSquared = squaredRewardSum().load() / v;
     return meanSquared - mean * mean;
 }
 
+void MCTSNode::loadChildStatistics(ChildStatistics& stats) const {
+    stats = ChildStatistics();
+    stats.count = children.size();
+    for (size_t i = 0; i < stats.count; ++i) {
+        int v = childVisits[i].load(std::memory_order_relaxed);
+        stats.actions[i] = children[i]->action;
+        stats.visits[i] = v;
+        if (v > 0) {
+            stats.meanReward[i] = childTotalReward[i].load(std::memory_order_relaxed) / v;
+            stats.meanSquaredReward[i] = childTotalSquaredReward[i].load(std::memory_order_relaxed) / v;
+        }
+        stats.virtualLoss[i] = childVirtualLoss[i].load(std::memory_order_relaxed);
+        int action = static_cast<int>(children[i]->action);
+        stats.prior[i] = actionPriors[action];
+        int raveCount = raveVisits[action].load(std::memory_order_relaxed);
+        stats.raveVisits[i] = raveCount;
+        if (raveCount > 0) {
+            stats.raveMeanReward[i] = raveRewards[action].load(std::memory_order_relaxed) / raveCount;
+        }
+    }
+    stats.provenLoss = provenLossChildren.load(std::memory_order_acquire);
+}
+
 MCTSNode* MCTSNode::getBestChild(double explorationConstant) const {
     if (children.empty()) return nullptr;
     
     if (explorationConstant == 0.0) {
         // Pure exploitation - select child with highest average reward
         auto it = std::max_element(children.begin(), children.end(),
-            [](const std::unique_ptr<MCTSNode>& a, const std::unique_ptr<MCTSNode>& b) {
+            [](const MCTSNode* a, const MCTSNode* b) {
                 return a->getAverageReward() < b->getAverageReward();
             });
-        return it->get();
+        return *it;
     } else {
         // UCB-based selection
         auto it = std::max_element(children.begin(), children.end(),
-            [explorationConstant](const std::unique_ptr<MCTSNode>& a, const std::unique_ptr<MCTSNode>& b) {
+            [explorationConstant](const MCTSNode* a, const MCTSNode* b) {
                 return a->calculateUCB1Tuned(explorationConstant) < b->calculateUCB1Tuned(explorationConstant);
             });
-        return it->get();
+        return *it;
     }
 }
 
@@ -202,33 +252,52 @@ MCTSNode* MCTSNode::getMostVisitedChild() const {
     if (children.empty()) return nullptr;
     
     auto it = std::max_element(children.begin(), children.end(),
-        [](const std::unique_ptr<MCTSNode>& a, const std::unique_ptr<MCTSNode>& b) {
+        [](const MCTSNode* a, const MCTSNode* b) {
             return a->getVisits() < b->getVisits();
         });
-    return it->get();
+    return *it;
+}
+
+bool MCTSNode::isProvenLoss() const {
+    if (parent) {
+        return (parent->provenLossChildren.load(std::memory_order_acquire) >> slot) & 1u;
+    }
+    // A root has no parent bit; it is lost if every move from it is
+    return isFullyExpandedNode() && !children.empty() &&
+           provenLossChildren.load(std::memory_order_acquire) == (1u << children.size()) - 1;
+}
+
+void MCTSNode::markProvenLoss() {
+    for (MCTSNode* node = this; node->parent; node = node->parent) {
+        MCTSNode* up = node->parent;
+        uint32_t lost = up->provenLossChildren.fetch_or(1u << node->slot, std::memory_order_acq_rel) |
+                        (1u << node->slot);
+        // The parent is lost too once it can gain no new move and all of its moves lose
+        if (!up->isFullyExpandedNode() || lost != (1u << up->children.size()) - 1) {
+            return;
+        }
+    }
 }
 
 void MCTSNode::updateRAVE(BotAction action, double reward) {
-    auto& [totalReward, visits] = raveStats[action];
+    int index = static_cast<int>(action);
+    auto& totalReward = raveRewards[index];
     double currentRaveReward = totalReward.load(std::memory_order_relaxed);
     double newRaveReward;
     do {
         newRaveReward = currentRaveReward + reward;
     } while (!totalReward.compare_exchange_weak(currentRaveReward, newRaveReward, std::memory_order_release, std::memory_order_relaxed));
-    visits.fetch_add(1, std::memory_order_relaxed); // fetch_add for int is fine
+    raveVisits[index].fetch_add(1, std::memory_order_relaxed); // fetch_add for int is fine
 }
 
 double MCTSNode::getRAVEValue(BotAction action) const {
-    auto it = raveStats.find(action);
-    if (it != raveStats.end() && it->second.second.load() > 0) {
-        return it->second.first.load() / it->second.second.load();
-    }
-    return 0.0;
+    int index = static_cast<int>(action);
+    int visits = raveVisits[index].load();
+    return visits > 0 ? raveRewards[index].load() / visits : 0.0;
 }
 
 int MCTSNode::getRAVEVisits(BotAction action) const {
-    auto it = raveStats.find(action);
-    return it != raveStats.end() ? it->second.second.load() : 0;
+    return raveVisits[static_cast<int>(action)].load();
 }
 
 int MCTSNode::getDepth() const {
@@ -262,12 +331,67 @@ std::vector<BotAction> MCTSNode::getPathFromRoot() const {
     return path;
 }
 
+bool MCTSNode::promoteToRoot(NodePool& pool, const GameState& observed) {
+    if (gameState) {
+        *gameState = observed;
+    } else if (!(gameState = pool.createState(observed))) {
+        return false;
+    }
+    
+    // Take the statistics out of the parent's arrays before detaching
+    visits = getVisits();
+    totalReward = getTotalReward();
+    totalSquaredReward = squaredRewardSum().load();
+    parent = nullptr;
+    slot = 0;
+    stateHash = observed.hash();
+    isTerminal = gameState->isTerminal();
+    if (isTerminal.load()) {
+        isFullyExpanded = true;
+    }
+    cachedUCBVisits = -1;
+    return true;
+}
+
+MCTSNode* MCTSNode::cloneSubtree(NodePool& pool, MCTSNode* newParent) const {
+    MCTSNode* copy = pool.createNode(stateHash, isTerminal.load(), untriedActions.load(), newParent,
+                                     action, playerId);
+    if (!copy) return nullptr;
+    if (gameState && !(copy->gameState = pool.createState(*gameState))) return nullptr;
+    
+    copy->visitCounter() = getVisits();
+    copy->rewardSum() = getTotalReward();
+    copy->squaredRewardSum() = squaredRewardSum().load();
+    for (int i = 0; i < BOT_ACTION_COUNT; ++i) {
+        copy->raveRewards[i] = raveRewards[i].load();
+        copy->raveVisits[i] = raveVisits[i].load();
+    }
+    copy->isFullyExpanded = isFullyExpanded.load();
+    copy->actionPriors = actionPriors;
+    copy->hasPriors = hasPriors;
+    
+    for (const auto& child : children) {
+        MCTSNode* childCopy = child->cloneSubtree(pool, copy);
+        if (!childCopy) {
+            // Out of space: keep what was copied and let expansion fill the rest
+            copy->isFullyExpanded = copy->isTerminal.load();
+            break;
+        }
+        copy->children.push_back(childCopy);
+    }
+    for (size_t i = copy->children.size(); i < children.size(); ++i) {
+        copy->untriedActions.fetch_or(1u << static_cast<int>(children[i]->action));
+    }
+    copy->provenLossChildren = provenLossChildren.load() & ((1u << copy->children.size()) - 1);
+    return copy;
+}
+
 void MCTSNode::printTree(int maxDepth, int currentDepth) const {
     if (currentDepth > maxDepth) return;
     
     std::string indent(currentDepth * 2, ' ');
     std::cout << indent << "Action: " << static_cast<int>(action) 
-              << ", Visits: " << visits.load()
+              << ", Visits: " << getVisits()
               << ", Avg Reward: " << std::fixed << std::setprecision(3) << getAverageReward()
               << ", UCB: " << calculateUCB1Tuned(1.414) << std::endl;
     
@@ -279,8 +403,8 @@ void MCTSNode::printTree(int maxDepth, int currentDepth) const {
 void MCTSNode::printStatistics() const {
     std::cout << "=== Node Statistics ===" << std::endl;
     std::cout << "Action: " << static_cast<int>(action) << std::endl;
-    std::cout << "Visits: " << visits.load() << std::endl;
-    std::cout << "Total Reward: " << totalReward.load() << std::endl;
+    std::cout << "Visits: " << getVisits() << std::endl;
+    std::cout << "Total Reward: " << getTotalReward() << std::endl;
     std::cout << "Average Reward: " << getAverageReward() << std::endl;
     std::cout << "Reward Variance: " << getRewardVariance() << std::endl;
     std::cout << "Children: " << children.size() << std::endl;
@@ -293,32 +417,12 @@ void MCTSNode::printStatistics() const {
 std::string MCTSNode::toString() const {
     std::ostringstream oss;
     oss << "MCTSNode[Action=" << static_cast<int>(action)
-        << ", Visits=" << visits.load()
+        << ", Visits=" << getVisits()
         << ", AvgReward=" << std::fixed << std::setprecision(3) << getAverageReward()
         << ", Children=" << children.size() << "]";
     return oss.str();
 }
 
-std::vector<BotAction> MCTSNode::getUntriedActions() const {
-    auto legalActions = gameState->getLegalActions(playerId);
-    std::vector<BotAction> untriedActions;
-    
-    for (const auto& action : legalActions) {
-        bool found = false;
-        for (const auto& child : children) {
-            if (child->action == action) {
-                found = true;
-                break;
-            }
-        }
-        if (!found) {
-            untriedActions.push_back(action);
-        }
-    }
-    
-    return untriedActions;
-}
-
 void MCTSNode::markAsTerminal() {
     isTerminal = true;
     isFullyExpanded = true;
@@ -335,14 +439,15 @@ void MCTSNode::updateCachedValues() const {
 
 void MCTSNode::atomicAddReward(double reward) {
     // Atomic addition for thread safety
-    double expected = totalReward.load();
-    while (!totalReward.compare_exchange_weak(expected, expected + reward)) {
+    std::atomic<double>& sum = rewardSum();
+    double expected = sum.load();
+    while (!sum.compare_exchange_weak(expected, expected + reward)) {
         // Retry until successful
     }
 }
 
 void MCTSNode::atomicIncrementVisits() {
-    visits.fetch_add(1);
+    visitCounter().fetch_add(1);
 }
 
 // TreeStatistics implementation
@@ -362,7 +467,7 @@ TreeStatistics TreeStatistics::analyze(const MCTSNode* root) {
         }
         
         for (const auto& child : node->getChildren()) {
-            traverse(child.get(), depth + 1);
+            traverse(child, depth + 1);
         }
     };
     
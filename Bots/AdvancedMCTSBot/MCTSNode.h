@@ -1,33 +1,100 @@
 #pragma once
 
 #include "GameState.h"
+#include "FixedVector.h"
+#include "SlabArena.h"
 #include <vector>
 #include <memory>
-#include <unordered_map>
+#include <array>
 #include <atomic>
-#include <mutex>
+#include <string>
 
+class NodePool;
+
+// Nodes live in a NodePool and are released all at once with it, so a node
+// must stay trivially destructible: no owning members.
 class MCTSNode {
+public:
+    using ChildList = FixedVector<MCTSNode*, BOT_ACTION_COUNT>;
+
+    // Plain copy of every child's statistics, loaded once per selection step
+    // so bandit formulas run over flat arrays. Slots past count read as
+    // unvisited, letting a pass cover all BOT_ACTION_COUNT lanes.
+    struct ChildStatistics {
+        size_t count = 0;
+        std::array<BotAction, BOT_ACTION_COUNT> actions{};
+        std::array<double, BOT_ACTION_COUNT> visits{};
+        std::array<double, BOT_ACTION_COUNT> meanReward{};
+        std::array<double, BOT_ACTION_COUNT> meanSquaredReward{};
+        std::array<double, BOT_ACTION_COUNT> virtualLoss{};
+        std::array<double, BOT_ACTION_COUNT> prior{};
+        // This node's RAVE statistics for each child's action
+        std::array<double, BOT_ACTION_COUNT> raveVisits{};
+        std::array<double, BOT_ACTION_COUNT> raveMeanReward{};
+        // Bit i set if child i is a proven loss
+        uint32_t provenLoss = 0;
+    };
+
 private:
-    // Node state
-    std::unique_ptr<GameState> gameState;
+    // Only a root holds a GameState (owned by the NodePool); every other node
+    // is an (action, statistics, prior) record whose state is rebuilt on
+    // demand by replaying the actions from the root. Children are appended
+    // only by the thread holding the expansion claim; other threads iterate
+    // them once isFullyExpanded is set, which publishes the list.
+    GameState* gameState;
+    // Zobrist key of this node's state, recorded when the node was created
+    uint64_t stateHash;
     MCTSNode* parent;
-    std::vector<std::unique_ptr<MCTSNode>> children;
+    ChildList children;
+    // Index of this node in parent->children
+    uint8_t slot;
     
-    // MCTS statistics
+    // MCTS statistics of this node while it is a root. A child's statistics
+    // live in its parent's per-child arrays below (structure of arrays), so
+    // selecting among siblings reads contiguous memory instead of chasing
+    // every child pointer; the accessors pick the right storage.
     std::atomic<int> visits;
     std::atomic<double> totalReward;
     std::atomic<double> totalSquaredReward; // For UCB1-Tuned
     
+    std::array<std::atomic<int>, BOT_ACTION_COUNT> childVisits;
+    std::array<std::atomic<double>, BOT_ACTION_COUNT> childTotalReward;
+    std::array<std::atomic<double>, BOT_ACTION_COUNT> childTotalSquaredReward;
+    std::array<std::atomic<int>, BOT_ACTION_COUNT> childVirtualLoss;
+    // MCTS-Solver: bit i set once children[i] is a proven loss, i.e. its
+    // player is caught there or every one of its own moves is a proven loss
+    std::atomic<uint32_t> provenLossChildren;
+    // Legal actions without a child yet, as a BotAction bitmask; cleared bit
+    // by bit by the thread holding the expansion claim
+    std::atomic<uint32_t> untriedActions;
+    
+    std::atomic<int>& visitCounter() { return parent ? parent->childVisits[slot] : visits; }
+    const std::atomic<int>& visitCounter() const { return parent ? parent->childVisits[slot] : visits; }
+    std::atomic<double>& rewardSum() { return parent ? parent->childTotalReward[slot] : totalReward; }
+    const std::atomic<double>& rewardSum() const { return parent ? parent->childTotalReward[slot] : totalReward; }
+    std::atomic<double>& squaredRewardSum() { return parent ? parent->childTotalSquaredReward[slot] : totalSquaredReward; }
+    const std::atomic<double>& squaredRewardSum() const {
+        return parent ? parent->childTotalSquaredReward[slot] : totalSquaredReward;
+    }
+    
     // Action that led to this node
     BotAction action;
-    std::string playerId;
+    AnimalHandle playerId;
     
-    // RAVE statistics
-    std::unordered_map<BotAction, std::pair<std::atomic<double>, std::atomic<int>>> raveStats;
+    // Heuristic prior of each action from this node's state, in [0, 1]. Set
+    // once by the thread expanding the first child, so the children and their
+    // priors are published together.
+    std::array<double, BOT_ACTION_COUNT> actionPriors{};
+    bool hasPriors = false;
     
-    // Threading support
-    mutable std::mutex expansionMutex;
+    // RAVE (all-moves-as-first) statistics, indexed by BotAction: every
+    // simulation through this node adds its reward under each action it
+    // played afterwards, in the tree or the rollout, once per action
+    std::array<std::atomic<double>, BOT_ACTION_COUNT> raveRewards;
+    std::array<std::atomic<int>, BOT_ACTION_COUNT> raveVisits;
+    
+    // Threading support: expansion claim (pending virtual losses sit in the
+    // parent's childVirtualLoss)
     std::atomic<bool> isExpanding;
     
     // Node properties
@@ -39,43 +106,70 @@ private:
     mutable std::atomic<int> cachedUCBVisits;
     
 public:
-    MCTSNode(std::unique_ptr<GameState> state, MCTSNode* parent = nullptr, 
-             BotAction action = BotAction::Up, const std::string& playerId = "");
+    // A node for a state with the given key and legal actions (a BotAction
+    // bitmask); NodePool::createRoot attaches the state itself to roots
+    MCTSNode(uint64_t stateHash, bool terminal, uint32_t legalActions, MCTSNode* parent = nullptr,
+             BotAction action = BotAction::Up, AnimalHandle playerId = INVALID_HANDLE);
     
-    ~MCTSNode();
+    // playerId's legal actions in state as a BotAction bitmask
+    static uint32_t legalActionMask(const GameState& state, AnimalHandle playerId);
     
     // Core MCTS operations
     MCTSNode* select(double explorationConstant);
-    MCTSNode* expand();
+    // state must be this node's state. When a child is added, its action is
+    // applied to state (logged to undoLog), which then stands for the child.
+    MCTSNode* expand(NodePool& pool, GameState& state, std::vector<StateDelta>& undoLog);
     void update(double reward);
+    // Initialises an unvisited node from statistics gathered elsewhere (transpositions)
+    void seedStatistics(int visits, double avgReward);
     
     // UCB calculations
     double calculateUCB1(double explorationConstant) const;
     double calculateUCB1Tuned(double explorationConstant) const;
-    double calculateRAVEValue() const;
     
     // Node properties
     bool isLeaf() const { return children.empty(); }
-    bool hasUntriedActions() const;
+    bool hasUntriedActions() const {
+        return !isTerminalNode() && untriedActions.load(std::memory_order_relaxed) != 0;
+    }
     bool isTerminalNode() const { return isTerminal.load(); }
     bool isFullyExpandedNode() const { return isFullyExpanded.load(); }
     
     // Statistics
-    int getVisits() const { return visits.load(); }
+    int getVisits() const { return visitCounter().load(); }
     double getAverageReward() const;
     double getRewardVariance() const;
-    double getTotalReward() const { return totalReward.load(); }
+    double getTotalReward() const { return rewardSum().load(); }
+    // Snapshot of the children's statistics, in getChildren() order
+    void loadChildStatistics(ChildStatistics& stats) const;
+    
+    // Heuristic priors, computed at expansion and read by progressive bias
+    bool hasActionPriors() const { return hasPriors; }
+    void setActionPriors(const std::array<double, BOT_ACTION_COUNT>& priors) {
+        actionPriors = priors;
+        hasPriors = true;
+    }
+    // Prior of the action that led here (0 for a root)
+    double getPrior() const { return parent ? parent->actionPriors[static_cast<int>(action)] : 0.0; }
     
     // Tree navigation
     MCTSNode* getParent() const { return parent; }
-    const std::vector<std::unique_ptr<MCTSNode>>& getChildren() const { return children; }
+    const ChildList& getChildren() const { return children; }
     MCTSNode* getBestChild(double explorationConstant = 0.0) const;
     MCTSNode* getMostVisitedChild() const;
     
-    // Game state access
+    // Game state access: only roots keep their state
+    bool hasGameState() const { return gameState != nullptr; }
     const GameState& getGameState() const { return *gameState; }
+    uint64_t getStateHash() const { return stateHash; }
     BotAction getAction() const { return action; }
-    const std::string& getPlayerId() const { return playerId; }
+    AnimalHandle getPlayerId() const { return playerId; }
+    
+    // MCTS-Solver. A proven loss needs no more simulations: selection skips
+    // it and the final move avoids it while any other move is open.
+    bool isProvenLoss() const;
+    // Marks this node a proven loss, then every ancestor left with no other move
+    void markProvenLoss();
     
     // RAVE support
     void updateRAVE(BotAction action, double reward);
@@ -87,10 +181,27 @@ public:
     int getTreeSize() const;
     std::vector<BotAction> getPathFromRoot() const;
     
+    // Tree reuse across ticks
+    // Detaches this node from its parent and gives it the observed state from
+    // pool; false if the pool has no room for the state
+    bool promoteToRoot(NodePool& pool, const GameState& observed);
+    // Deep-copies this subtree (statistics, and the state of a root) into
+    // pool; nullptr if it is full
+    MCTSNode* cloneSubtree(NodePool& pool, MCTSNode* newParent) const;
+    
     // Threading support
-    void lockExpansion() { expansionMutex.lock(); }
-    void unlockExpansion() { expansionMutex.unlock(); }
-    bool tryLockExpansion() { return expansionMutex.try_lock(); }
+    bool tryLockExpansion() {
+        bool expected = false;
+        return isExpanding.compare_exchange_strong(expected, true, std::memory_order_acquire);
+    }
+    void unlockExpansion() { isExpanding.store(false, std::memory_order_release); }
+    bool isExpansionLocked() const { return isExpanding.load(std::memory_order_acquire); }
+    // Virtual loss is only ever put on non-root nodes
+    void addVirtualLoss() { parent->childVirtualLoss[slot].fetch_add(1, std::memory_order_relaxed); }
+    void removeVirtualLoss() { parent->childVirtualLoss[slot].fetch_sub(1, std::memory_order_relaxed); }
+    int getVirtualLoss() const {
+        return parent ? parent->childVirtualLoss[slot].load(std::memory_order_relaxed) : 0;
+    }
     
     // Debugging and analysis
     void printTree(int maxDepth = 3, int currentDepth = 0) const;
@@ -98,8 +209,9 @@ public:
     std::string toString() const;
     
 private:
+    friend class NodePool;
+    
     // Helper methods
-    std::vector<BotAction> getUntriedActions() const;
     void markAsTerminal();
     void markAsFullyExpanded();
     void updateCachedValues() const;
@@ -111,17 +223,50 @@ private:
 
 // Node comparison functors
 struct NodeComparator {
-    bool operator()(const std::unique_ptr<MCTSNode>& a, const std::unique_ptr<MCTSNode>& b) const {
+    bool operator()(const MCTSNode* a, const MCTSNode* b) const {
         return a->getAverageReward() > b->getAverageReward();
     }
 };
 
 struct NodeVisitComparator {
-    bool operator()(const std::unique_ptr<MCTSNode>& a, const std::unique_ptr<MCTSNode>& b) const {
+    bool operator()(const MCTSNode* a, const MCTSNode* b) const {
         return a->getVisits() > b->getVisits();
     }
 };
 
+// Per-search storage for the tree. Nodes and the roots' states are
+// bump-allocated from slabs and the whole tree is dropped with reset(), in O(1).
+class NodePool {
+private:
+    SlabArena<MCTSNode, 4096> nodes;
+    // One state per root, so one per tick the tree is carried over
+    SlabArena<GameState, 16> states;
+
+public:
+    // All return nullptr when the pool is exhausted
+    GameState* createState(const GameState& state) { return states.create(state); }
+    MCTSNode* createNode(uint64_t stateHash, bool terminal, uint32_t legalActions, MCTSNode* parent,
+                         BotAction action, AnimalHandle playerId) {
+        return nodes.create(stateHash, terminal, legalActions, parent, action, playerId);
+    }
+    // A root holding a copy of state
+    MCTSNode* createRoot(const GameState& state, AnimalHandle playerId) {
+        GameState* copy = states.create(state);
+        MCTSNode* root = copy ? nodes.create(state.hash(), state.isTerminal(),
+                                             MCTSNode::legalActionMask(state, playerId),
+                                             nullptr, BotAction::Up, playerId)
+                              : nullptr;
+        if (root) root->gameState = copy;
+        return root;
+    }
+
+    void reset() {
+        nodes.reset();
+        states.reset();
+    }
+    size_t nodeCount() const { return nodes.size(); }
+};
+
 // Tree statistics collector
 class TreeStatistics {
 public:
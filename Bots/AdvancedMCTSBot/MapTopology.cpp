@@ -0,0 +1,47 @@
+#include "MapTopology.h"
+#include <algorithm>
+#include <mutex>
+
+MapTopology::MapTopology(ConstructionKey, const BitBoard& walls)
+    : width(walls.getWidth()),
+      height(walls.getHeight()),
+      wallBoard(walls),
+      openBoard(~walls),
+      cells(static_cast<size_t>(width) * height),
+      distances(DistanceTable::forWalls(walls)) {
+    for (int y = 0; y < height; ++y) {
+        for (int x = 0; x < width; ++x) {
+            if (!isOpen(x, y)) continue;
+
+            CellInfo& info = cells[cellIndex(x, y)];
+            if (isOpen(x, y - 1)) info.neighbours |= OPEN_UP;
+            if (isOpen(x, y + 1)) info.neighbours |= OPEN_DOWN;
+            if (isOpen(x - 1, y)) info.neighbours |= OPEN_LEFT;
+            if (isOpen(x + 1, y)) info.neighbours |= OPEN_RIGHT;
+            info.degree = static_cast<uint8_t>(BitOps::popcount(info.neighbours));
+            info.kind = info.degree <= 1 ? CellKind::DeadEnd
+                      : info.degree == 2 ? CellKind::Corridor
+                                         : CellKind::Junction;
+        }
+    }
+}
+
+std::shared_ptr<const MapTopology> MapTopology::forWalls(const BitBoard& walls) {
+    static std::mutex cacheMutex;
+    static std::vector<std::weak_ptr<const MapTopology>> cache;
+
+    std::lock_guard<std::mutex> lock(cacheMutex);
+    cache.erase(std::remove_if(cache.begin(), cache.end(),
+                               [](const std::weak_ptr<const MapTopology>& entry) { return entry.expired(); }),
+                cache.end());
+    for (const auto& entry : cache) {
+        auto topology = entry.lock();
+        if (topology && topology->matches(walls)) {
+            return topology;
+        }
+    }
+
+    auto topology = std::make_shared<const MapTopology>(ConstructionKey{}, walls);
+    cache.push_back(topology);
+    return topology;
+}
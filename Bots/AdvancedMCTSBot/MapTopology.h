@@ -0,0 +1,74 @@
+#pragma once
+
+#include "BitBoard.h"
+#include "DistanceTable.h"
+#include <cstdint>
+#include <memory>
+#include <vector>
+
+// How a cell sits in the maze, from its number of open orthogonal neighbours
+enum class CellKind : uint8_t {
+    Wall = 0,
+    DeadEnd = 1,  // at most one way out
+    Corridor = 2, // exactly two
+    Junction = 3  // three or four
+};
+
+// Everything about one map that never changes during a game: walls, which
+// neighbours of each cell are open, degree and corridor/junction class, and
+// the DistanceTable. Built once per map and shared read-only by every state,
+// clone and search thread through GameState::setTopology(); states keep no
+// walls of their own. Always created through forWalls(), so holders of a
+// state's raw pointer can take shared ownership with shared_from_this().
+class MapTopology : public std::enable_shared_from_this<MapTopology> {
+    // Only forWalls() can name this, so no topology exists outside a shared_ptr
+    struct ConstructionKey {
+        explicit ConstructionKey() = default;
+    };
+
+public:
+    // Neighbour mask bits, in BotAction order (Up = 1 ... Right = 4)
+    static constexpr uint8_t OPEN_UP = 1 << 0;
+    static constexpr uint8_t OPEN_DOWN = 1 << 1;
+    static constexpr uint8_t OPEN_LEFT = 1 << 2;
+    static constexpr uint8_t OPEN_RIGHT = 1 << 3;
+
+    // Topology for a map's walls, built on the first request for that map and
+    // shared with every later caller while someone still holds it
+    static std::shared_ptr<const MapTopology> forWalls(const BitBoard& walls);
+
+    MapTopology(ConstructionKey, const BitBoard& walls);
+
+    int getWidth() const { return width; }
+    int getHeight() const { return height; }
+    // Row-major index used by every per-cell lookup here and in DistanceTable
+    int cellIndex(int x, int y) const { return y * width + x; }
+
+    bool isWall(int cell) const { return cells[cell].kind == CellKind::Wall; }
+    bool isOpen(int x, int y) const { return openBoard.get(x, y); }
+    const BitBoard& getWalls() const { return wallBoard; }
+    const BitBoard& getOpen() const { return openBoard; }
+    // OPEN_* bits of the in-bounds, non-wall neighbours; 0 for a wall
+    uint8_t neighbourMask(int cell) const { return cells[cell].neighbours; }
+    int degree(int cell) const { return cells[cell].degree; }
+    CellKind kind(int cell) const { return cells[cell].kind; }
+
+    const DistanceTable& getDistances() const { return *distances; }
+
+    // True if this topology was built for exactly these walls
+    bool matches(const BitBoard& walls) const { return walls == wallBoard; }
+
+private:
+    struct CellInfo {
+        uint8_t neighbours = 0;
+        uint8_t degree = 0;
+        CellKind kind = CellKind::Wall;
+    };
+
+    int width;
+    int height;
+    BitBoard wallBoard;
+    BitBoard openBoard;
+    std::vector<CellInfo> cells;
+    std::shared_ptr<const DistanceTable> distances;
+};
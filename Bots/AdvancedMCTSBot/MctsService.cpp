@@ -14,16 +14,18 @@ MctsService::MctsService(int maxIterations, int timeLimit, int numThreads, int m
         timeLimit,
         finalNumThreads
     );
-}
 
-void MctsService::SetBotId(std::string botId) {
-    this->botId = botId;
+    // Workers are created once here and parked between ticks
+    if (finalNumThreads > 1) {
+        threadPool = std::make_unique<SearchThreadPool>(static_cast<int>(finalNumThreads));
+        mctsEngine->setThreadPool(threadPool.get());
+    }
 }
 
-MCTSResult MctsService::GetBestAction(const GameState& gameState) {
-    if (botId.empty()) {
-        // Return a default/safe action if we don't have an ID yet.
+MCTSResult MctsService::GetBestAction(const GameState& gameState, std::chrono::steady_clock::time_point tickStart) {
+    if (gameState.myAnimal == INVALID_HANDLE) {
+        // Return a default/safe action if we haven't been located in the state yet.
         return MCTSResult{BotAction::None, {}};
     }
-    return mctsEngine->findBestAction(gameState, botId);
+    return mctsEngine->findBestAction(gameState, gameState.myAnimal, tickStart);
 }
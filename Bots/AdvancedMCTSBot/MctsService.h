@@ -1,17 +1,21 @@
 #pragma once
 
 #include "MCTSEngine.h"
+#include "SearchThreadPool.h"
 #include "GameState.h"
+#include <chrono>
 #include <string>
 #include <memory>
 
 class MctsService {
 public:
     MctsService(int maxIterations, int timeLimit, int numThreads = 0, int maxDepth = 30);
-    void SetBotId(std::string botId);
-    MCTSResult GetBestAction(const GameState& gameState);
+    // Searches until timeLimit after tickStart
+    MCTSResult GetBestAction(const GameState& gameState,
+                             std::chrono::steady_clock::time_point tickStart = std::chrono::steady_clock::now());
 
 private:
+    // Declared before the engine so it is destroyed after it
+    std::unique_ptr<SearchThreadPool> threadPool;
     std::unique_ptr<MCTSEngine> mctsEngine;
-    std::string botId;
 };
@@ -0,0 +1,61 @@
+#include "SearchThreadPool.h"
+
+SearchThreadPool::SearchThreadPool(int concurrency) {
+    for (int participant = 1; participant < concurrency; ++participant) {
+        workers.emplace_back(&SearchThreadPool::workerLoop, this, participant);
+    }
+}
+
+SearchThreadPool::~SearchThreadPool() {
+    {
+        std::lock_guard<std::mutex> lock(mutex);
+        stopping = true;
+    }
+    wakeWorkers.notify_all();
+    for (auto& worker : workers) {
+        worker.join();
+    }
+}
+
+void SearchThreadPool::run(const std::function<void(int)>& job) {
+    {
+        std::lock_guard<std::mutex> lock(mutex);
+        currentJob = &job;
+        pendingWorkers = static_cast<int>(workers.size());
+        ++jobSerial;
+    }
+    wakeWorkers.notify_all();
+
+    job(0);
+
+    std::unique_lock<std::mutex> lock(mutex);
+    jobFinished.wait(lock, [this] { return pendingWorkers == 0; });
+    currentJob = nullptr;
+}
+
+uint64_t SearchThreadPool::jobsRun() const {
+    std::lock_guard<std::mutex> lock(mutex);
+    return jobSerial;
+}
+
+void SearchThreadPool::workerLoop(int participant) {
+    uint64_t seenSerial = 0;
+    for (;;) {
+        const std::function<void(int)>* job;
+        {
+            std::unique_lock<std::mutex> lock(mutex);
+            wakeWorkers.wait(lock, [&] { return stopping || jobSerial != seenSerial; });
+            if (stopping) return;
+            seenSerial = jobSerial;
+            job = currentJob;
+        }
+
+        (*job)(participant);
+
+        {
+            std::lock_guard<std::mutex> lock(mutex);
+            --pendingWorkers;
+        }
+        jobFinished.notify_one();
+    }
+}
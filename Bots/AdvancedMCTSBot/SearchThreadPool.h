@@ -0,0 +1,41 @@
+#pragma once
+
+#include <condition_variable>
+#include <cstdint>
+#include <functional>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+// Fixed set of search threads created once and parked between ticks.
+// run() hands the same job to every participant - the calling thread plus
+// each worker - and returns when all of them have returned from it.
+class SearchThreadPool {
+public:
+    // concurrency counts the calling thread, so concurrency - 1 workers are spawned
+    explicit SearchThreadPool(int concurrency);
+    ~SearchThreadPool();
+
+    SearchThreadPool(const SearchThreadPool&) = delete;
+    SearchThreadPool& operator=(const SearchThreadPool&) = delete;
+
+    int concurrency() const { return static_cast<int>(workers.size()) + 1; }
+
+    // job receives the participant index in [0, concurrency()); the caller is 0
+    void run(const std::function<void(int)>& job);
+    // Jobs run so far, so callers can see successive searches sharing the pool
+    uint64_t jobsRun() const;
+
+private:
+    void workerLoop(int participant);
+
+    std::vector<std::thread> workers;
+    mutable std::mutex mutex;
+    std::condition_variable wakeWorkers;
+    std::condition_variable jobFinished;
+
+    const std::function<void(int)>* currentJob = nullptr;
+    uint64_t jobSerial = 0;
+    int pendingWorkers = 0;
+    bool stopping = false;
+};
@@ -0,0 +1,67 @@
+#pragma once
+
+#include <array>
+#include <atomic>
+#include <cstddef>
+#include <memory>
+#include <mutex>
+#include <new>
+#include <type_traits>
+#include <utility>
+
+// Bump allocator over fixed-size slabs. Objects are never destroyed one by
+// one: reset() rewinds the cursor in O(1) and keeps the slabs for the next
+// search, so T must not own anything that needs a destructor.
+// create() is safe to call from several threads at once.
+template<typename T, size_t SLAB_SIZE, size_t MAX_SLABS = 1024>
+class SlabArena {
+    static_assert(std::is_trivially_destructible<T>::value, "SlabArena::reset() does not run destructors");
+
+private:
+    using Slot = typename std::aligned_storage<sizeof(T), alignof(T)>::type;
+
+    std::array<std::unique_ptr<Slot[]>, MAX_SLABS> ownedSlabs;
+    std::array<std::atomic<Slot*>, MAX_SLABS> slabs{};
+    std::atomic<size_t> cursor{0};
+    std::mutex growMutex;
+
+    Slot* slabFor(size_t slabIndex) {
+        Slot* slab = slabs[slabIndex].load(std::memory_order_acquire);
+        if (slab) return slab;
+
+        std::lock_guard<std::mutex> lock(growMutex);
+        slab = slabs[slabIndex].load(std::memory_order_relaxed);
+        if (!slab) {
+            ownedSlabs[slabIndex].reset(new Slot[SLAB_SIZE]);
+            slab = ownedSlabs[slabIndex].get();
+            slabs[slabIndex].store(slab, std::memory_order_release);
+        }
+        return slab;
+    }
+
+public:
+    SlabArena() = default;
+    SlabArena(const SlabArena&) = delete;
+    SlabArena& operator=(const SlabArena&) = delete;
+
+    static constexpr size_t capacity() { return SLAB_SIZE * MAX_SLABS; }
+
+    // Returns nullptr once the arena is exhausted
+    template<typename... Args>
+    T* create(Args&&... args) {
+        size_t index = cursor.fetch_add(1, std::memory_order_relaxed);
+        if (index >= capacity()) {
+            return nullptr;
+        }
+        Slot* slab = slabFor(index / SLAB_SIZE);
+        return new (&slab[index % SLAB_SIZE]) T(std::forward<Args>(args)...);
+    }
+
+    // Invalidates every object handed out so far. Not safe against concurrent create().
+    void reset() { cursor.store(0, std::memory_order_relaxed); }
+
+    size_t size() const {
+        size_t used = cursor.load(std::memory_order_relaxed);
+        return used < capacity() ? used : capacity();
+    }
+};
@@ -1,4 +1,5 @@
 #include "MctsService.h"
+#include "MCTSEngine.h"
 #include "GameState.h"
 #include "tests/JsonGameStateLoader.h"
 #include "tests/CommonFunctionalTest.h"
@@ -6,10 +7,80 @@
 #include <cassert>
 #include <string>
 #include <iomanip>
+#include <algorithm>
+#include <cmath>
 #include <vector>
+#include <atomic>
+#include <chrono>
+#include <cstddef>
+#include <cstdlib>
+#include <new>
+#include <stdexcept>
+#if defined(_MSC_VER)
+#include <malloc.h>
+#endif
 
 // actionToString is already defined in CommonFunctionalTest.h
 
+// Test-only global allocation counter: every operator new in this binary bumps it,
+// including the aligned and nothrow forms, so no allocation can slip past the checks
+static std::atomic<long long> g_allocationCount{0};
+
+// malloc/free kept behind helpers so the replaced new/delete pairs stay matched
+static void* countedAllocate(std::size_t size, std::size_t alignment) noexcept {
+    g_allocationCount.fetch_add(1, std::memory_order_relaxed);
+    if (size == 0) size = 1;
+    if (alignment <= alignof(std::max_align_t)) return std::malloc(size);
+#if defined(_MSC_VER)
+    return _aligned_malloc(size, alignment);
+#else
+    return std::aligned_alloc(alignment, (size + alignment - 1) / alignment * alignment);
+#endif
+}
+
+static void countedFree(void* p, std::size_t alignment) noexcept {
+#if defined(_MSC_VER)
+    if (alignment > alignof(std::max_align_t)) { _aligned_free(p); return; }
+#else
+    (void)alignment;
+#endif
+    std::free(p);
+}
+
+static void* countedAllocateOrThrow(std::size_t size, std::size_t alignment) {
+    if (void* p = countedAllocate(size, alignment)) return p;
+    throw std::bad_alloc();
+}
+
+#if defined(__GNUC__) && !defined(__clang__)
+#pragma GCC diagnostic push
+#pragma GCC diagnostic ignored "-Wmismatched-new-delete"
+#endif
+void* operator new(std::size_t size) { return countedAllocateOrThrow(size, 0); }
+void* operator new[](std::size_t size) { return countedAllocateOrThrow(size, 0); }
+void* operator new(std::size_t size, std::align_val_t al) { return countedAllocateOrThrow(size, static_cast<std::size_t>(al)); }
+void* operator new[](std::size_t size, std::align_val_t al) { return countedAllocateOrThrow(size, static_cast<std::size_t>(al)); }
+void* operator new(std::size_t size, const std::nothrow_t&) noexcept { return countedAllocate(size, 0); }
+void* operator new[](std::size_t size, const std::nothrow_t&) noexcept { return countedAllocate(size, 0); }
+void* operator new(std::size_t size, std::align_val_t al, const std::nothrow_t&) noexcept { return countedAllocate(size, static_cast<std::size_t>(al)); }
+void* operator new[](std::size_t size, std::align_val_t al, const std::nothrow_t&) noexcept { return countedAllocate(size, static_cast<std::size_t>(al)); }
+
+void operator delete(void* p) noexcept { countedFree(p, 0); }
+void operator delete[](void* p) noexcept { countedFree(p, 0); }
+void operator delete(void* p, std::size_t) noexcept { countedFree(p, 0); }
+void operator delete[](void* p, std::size_t) noexcept { countedFree(p, 0); }
+void operator delete(void* p, const std::nothrow_t&) noexcept { countedFree(p, 0); }
+void operator delete[](void* p, const std::nothrow_t&) noexcept { countedFree(p, 0); }
+void operator delete(void* p, std::align_val_t al) noexcept { countedFree(p, static_cast<std::size_t>(al)); }
+void operator delete[](void* p, std::align_val_t al) noexcept { countedFree(p, static_cast<std::size_t>(al)); }
+void operator delete(void* p, std::size_t, std::align_val_t al) noexcept { countedFree(p, static_cast<std::size_t>(al)); }
+void operator delete[](void* p, std::size_t, std::align_val_t al) noexcept { countedFree(p, static_cast<std::size_t>(al)); }
+void operator delete(void* p, std::align_val_t al, const std::nothrow_t&) noexcept { countedFree(p, static_cast<std::size_t>(al)); }
+void operator delete[](void* p, std::align_val_t al, const std::nothrow_t&) noexcept { countedFree(p, static_cast<std::size_t>(al)); }
+#if defined(__GNUC__) && !defined(__clang__)
+#pragma GCC diagnostic pop
+#endif
+
 // Test results structure
 struct TestResult {
     std::string testName;
@@ -17,6 +88,28 @@ struct TestResult {
     std::string message;
 };
 
+// A wall ring around a width x height grid
+static BitBoard borderWalls(int width, int height) {
+    BitBoard walls(width, height);
+    for (int x = 0; x < width; x++) {
+        walls.set(x, 0);
+        walls.set(x, height - 1);
+    }
+    for (int y = 0; y < height; y++) {
+        walls.set(0, y);
+        walls.set(width - 1, y);
+    }
+    return walls;
+}
+
+// Walls live in the map's topology, which a state only points at: the caller
+// keeps the returned topology alive while gs and its copies are in use
+static std::shared_ptr<const MapTopology> attachWalls(GameState& gs, const BitBoard& walls) {
+    auto topology = MapTopology::forWalls(walls);
+    gs.setTopology(topology.get());
+    return topology;
+}
+
 // Test 1: Cycle Detection Test
 TestResult runCycleDetectionTest() {
     std::cout << "\n=== Running Cycle Detection Test ===" << std::endl;
@@ -25,21 +118,13 @@ TestResult runCycleDetectionTest() {
     GameState gs(7, 7);
     
     // Set up walls around the perimeter
-    for (int x = 0; x < 7; x++) {
-        gs.setCell(x, 0, CellContent::Wall);  // Top wall
-        gs.setCell(x, 6, CellContent::Wall);  // Bottom wall
-    }
-    for (int y = 0; y < 7; y++) {
-        gs.setCell(0, y, CellContent::Wall);  // Left wall
-        gs.setCell(6, y, CellContent::Wall);  // Right wall
-    }
+    auto topology = attachWalls(gs, borderWalls(7, 7));
     
     // Place a pellet at the center
     gs.setCell(3, 3, CellContent::Pellet);
     
     // Create animal at starting position
     Animal animal;
-    animal.id = "testBot";
     animal.position = Position(1, 1);  // Start at top-left corner
     animal.score = 0;
     animal.scoreStreak = 0;
@@ -48,14 +133,12 @@ TestResult runCycleDetectionTest() {
     animal.heldPowerUp = PowerUpType::None;
     animal.powerUpDuration = 0;
     
-    gs.animals.push_back(animal);
-    gs.myAnimalId = "testBot";
+    gs.myAnimal = gs.addAnimal(animal);
     gs.tick = 1;
     gs.remainingTicks = 100;
     
     // Initialize MCTS service
     MctsService mcts(/*maxIterations*/10000, /*timeLimitMs*/500, /*numThreads*/1, /*maxDepth*/30);
-    mcts.SetBotId(gs.myAnimalId);
     
     // Test multiple iterations to ensure bot doesn't get stuck
     std::vector<BotAction> actionSequence;
@@ -68,11 +151,11 @@ TestResult runCycleDetectionTest() {
         std::cout << "Step " << step + 1 << ": Action = " << actionToString(result.bestAction) << std::endl;
         
         // Apply action to game state
-        gs.applyAction(gs.myAnimalId, result.bestAction);
+        gs.applyAction(gs.myAnimal, result.bestAction);
         actionSequence.push_back(result.bestAction);
         
         // Check if we found the pellet
-        Animal* animal = gs.getAnimal(gs.myAnimalId);
+        Animal* animal = gs.getMyAnimal();
         if (animal && animal->score > 0) {
             foundPellet = true;
             std::cout << "✅ Pellet found at step " << step + 1 << "!" << std::endl;
@@ -143,6 +226,618 @@ TestResult runCycleDetectionTest() {
     }
 }
 
+// Test: applyAction followed by undo must restore the exact original state
+TestResult runUndoRoundTripTest() {
+    std::cout << "\n=== Running Undo Round-Trip Test ===" << std::endl;
+
+    GameState gs(15, 15);
+    auto topology = attachWalls(gs, borderWalls(15, 15));
+    for (int x = 2; x <= 12; x++) {
+        gs.setCell(x, 7, CellContent::Pellet);
+    }
+    gs.setCell(5, 5, CellContent::PowerPellet);
+    gs.setCell(4, 6, CellContent::Scavenger);
+
+    Animal me;
+    me.position = Position(4, 7);
+    me.spawnPosition = Position(1, 1);
+    const AnimalHandle meHandle = gs.addAnimal(me);
+
+    Animal other;
+    other.position = Position(10, 10);
+    other.spawnPosition = Position(13, 13);
+    gs.addAnimal(other);
+
+    Zookeeper zk;
+    zk.position = Position(7, 9);
+    zk.target = meHandle;
+    zk.ticksSinceTargetUpdate = 17;
+    gs.addZookeeper(zk);
+
+    gs.myAnimal = meHandle;
+    gs.tick = 10;
+    gs.recomputeHash();
+
+    auto pelletField = [](const GameState& s) {
+        std::string out;
+        for (int y = 0; y < s.getHeight(); y++) {
+            for (int x = 0; x < s.getWidth(); x++) {
+                out += std::to_string(s.distanceToNearestPellet(Position(x, y))) + ",";
+            }
+        }
+        return out;
+    };
+
+    auto snapshot = [&pelletField](const GameState& s) {
+        std::string out = std::to_string(s.tick) + "|";
+        for (int y = 0; y < s.getHeight(); y++) {
+            for (int x = 0; x < s.getWidth(); x++) {
+                out += std::to_string(static_cast<int>(s.getCell(x, y)));
+            }
+        }
+        for (const auto& a : s.animals) {
+            out += "|" + std::to_string(a.position.x) + "," + std::to_string(a.position.y) +
+                   "," + std::to_string(a.score) + "," + std::to_string(a.scoreStreak) +
+                   "," + std::to_string(a.ticksSinceLastPellet) + "," + std::to_string(a.capturedCounter) +
+                   "," + std::to_string(a.distanceCovered) + "," + std::to_string(static_cast<int>(a.heldPowerUp)) +
+                   "," + std::to_string(a.powerUpDuration) + "," + std::to_string(a.isCaught);
+        }
+        for (const auto& z : s.zookeepers) {
+            out += "|" + std::to_string(z.position.x) + "," + std::to_string(z.position.y) +
+                   "," + std::to_string(z.target) + "," + std::to_string(z.ticksSinceTargetUpdate);
+        }
+        out += "|visited:" + std::to_string(s.getVisitedCount()) + "/" + std::to_string(s.getVisitedCells().count());
+        out += "|pellets:" + std::to_string(s.getPelletBoard().count());
+        out += "|hash:" + std::to_string(s.hash());
+        out += "|field:" + pelletField(s);
+        return out;
+    };
+
+    const std::string original = snapshot(gs);
+
+    // Eat pellets, pick up and fire the Scavenger, then walk into the zookeeper
+    const std::vector<BotAction> actions = {
+        BotAction::Right, BotAction::Left, BotAction::Up, BotAction::UseItem,
+        BotAction::Down, BotAction::Right, BotAction::Right, BotAction::Down,
+        BotAction::Down, BotAction::Right, BotAction::Left
+    };
+
+    std::vector<StateDelta> undoLog;
+    std::vector<std::string> snapshots;
+    for (BotAction action : actions) {
+        snapshots.push_back(snapshot(gs));
+        undoLog.push_back(gs.applyAction(gs.myAnimal, action));
+
+        // The incrementally maintained Zobrist key must match a full recompute
+        GameState rehashed = gs;
+        rehashed.recomputeHash();
+        if (rehashed.hash() != gs.hash()) {
+            return {"UndoRoundTrip", false, "Incremental hash diverged at step " + std::to_string(undoLog.size())};
+        }
+
+        // ...as must the maintained visited-cell count
+        if (gs.getVisitedCount() != gs.getVisitedCells().count()) {
+            return {"UndoRoundTrip", false, "Visited count diverged at step " + std::to_string(undoLog.size())};
+        }
+    }
+
+    while (!undoLog.empty()) {
+        gs.undo(undoLog.back());
+        undoLog.pop_back();
+        if (snapshot(gs) != snapshots[undoLog.size()]) {
+            return {"UndoRoundTrip", false, "State mismatch after undoing step " + std::to_string(undoLog.size() + 1)};
+        }
+    }
+
+    if (snapshot(gs) != original) {
+        return {"UndoRoundTrip", false, "State differs from original after full rewind"};
+    }
+    return {"UndoRoundTrip", true, "All " + std::to_string(actions.size()) + " steps rewound exactly"};
+}
+
+// Test: the next search continues from the subtree of the action that was played
+TestResult runTreeReuseTest() {
+    std::cout << "\n=== Running Tree Reuse Test ===" << std::endl;
+
+    GameState gs(11, 11);
+    auto topology = attachWalls(gs, borderWalls(11, 11));
+    for (int x = 2; x <= 8; x++) {
+        gs.setCell(x, 5, CellContent::Pellet);
+    }
+
+    Animal me;
+    me.position = Position(1, 5);
+    me.spawnPosition = Position(1, 1);
+    gs.myAnimal = gs.addAnimal(me);
+    gs.tick = 1;
+    gs.remainingTicks = 100;
+
+    MCTSEngine engine(1.8, /*maxIterations*/3000, /*maxSimulationDepth*/15, /*timeLimit*/200, /*numThreads*/1);
+    MCTSResult first = engine.findBestAction(gs, gs.myAnimal);
+    if (engine.getLastReusedVisits() != 0) {
+        return {"TreeReuse", false, "First search reported inherited visits"};
+    }
+
+    // The server state after our move is exactly what the tree predicted
+    gs.applyAction(gs.myAnimal, first.bestAction);
+    engine.findBestAction(gs, gs.myAnimal);
+    int inherited = engine.getLastReusedVisits();
+    if (inherited <= 0) {
+        return {"TreeReuse", false, "Matching state did not reuse the previous subtree"};
+    }
+
+    // A state the tree never predicted must start from scratch
+    GameState teleported = gs;
+    teleported.getMyAnimal()->position = Position(8, 8);
+    teleported.tick++;
+    engine.findBestAction(teleported, teleported.myAnimal);
+    if (engine.getLastReusedVisits() != 0) {
+        return {"TreeReuse", false, "Mismatched state reused a stale subtree"};
+    }
+
+    return {"TreeReuse", true, "Inherited " + std::to_string(inherited) + " visits from the previous tick"};
+}
+
+// Test: a four-thread search keeps its tree and its thread pool across ticks,
+// every iteration of every thread reaches the root exactly once, and the
+// expansion claims and virtual losses threads share the tree with are undone
+TestResult runParallelTreeReuseTest() {
+    std::cout << "\n=== Running Parallel Tree Reuse Test ===" << std::endl;
+
+    GameState gs(11, 11);
+    auto topology = attachWalls(gs, borderWalls(11, 11));
+    for (int x = 2; x <= 8; x++) {
+        gs.setCell(x, 3, CellContent::Pellet);
+        gs.setCell(x, 7, CellContent::Pellet);
+    }
+
+    Animal me;
+    me.position = Position(1, 5);
+    me.spawnPosition = Position(1, 1);
+    gs.myAnimal = gs.addAnimal(me);
+    gs.tick = 1;
+    gs.remainingTicks = 100;
+
+    constexpr int THREADS = 4;
+    constexpr int ITERATIONS = 3000;
+    constexpr int TICKS = 5;
+    SearchThreadPool pool(THREADS);
+    MCTSEngine engine(1.8, ITERATIONS, /*maxSimulationDepth*/15, /*timeLimit*/10000, THREADS);
+    engine.setThreadPool(&pool);
+    // Table-seeded visits would not come from simulations through the tree
+    engine.enableTranspositionTable(false);
+
+    int inheritedTotal = 0;
+    for (int tick = 0; tick < TICKS; tick++) {
+        MCTSResult result = engine.findBestAction(gs, gs.myAnimal);
+        const std::string at = " on tick " + std::to_string(tick);
+        int inherited = engine.getLastReusedVisits();
+        int simulations = engine.getTotalSimulations();
+        inheritedTotal += inherited;
+
+        if (tick > 0 && inherited <= 0) {
+            return {"ParallelTreeReuse", false, "Previous subtree not reused" + at};
+        }
+        // Threads stop on the shared count, so each may finish the iteration it is in
+        if (simulations < ITERATIONS || simulations >= ITERATIONS + THREADS) {
+            return {"ParallelTreeReuse", false, std::to_string(simulations) + " simulations" + at};
+        }
+        const MCTSNode* root = engine.getLastRoot();
+        if (!root || root->getVisits() != inherited + simulations) {
+            return {"ParallelTreeReuse", false, "Root visits are not inherited plus simulated" + at};
+        }
+
+        // Below the root a node has its children's visits plus at least the
+        // rollout from its own expansion. Once threads have joined, no virtual
+        // loss or expansion claim may be left, and no move expanded twice.
+        std::vector<const MCTSNode*> pending = {root};
+        while (!pending.empty()) {
+            const MCTSNode* node = pending.back();
+            pending.pop_back();
+            int childVisits = 0;
+            uint32_t expanded = 0;
+            for (const MCTSNode* child : node->getChildren()) {
+                uint32_t bit = 1u << static_cast<int>(child->getAction());
+                if (expanded & bit) {
+                    return {"ParallelTreeReuse", false, "A move was expanded twice" + at};
+                }
+                if (child->getVirtualLoss() != 0) {
+                    return {"ParallelTreeReuse", false, "Virtual loss left on the tree" + at};
+                }
+                expanded |= bit;
+                childVisits += child->getVisits();
+                pending.push_back(child);
+            }
+            if (node->getVisits() < childVisits + (node == root ? 0 : 1)) {
+                return {"ParallelTreeReuse", false, "A node has fewer visits than its subtree" + at};
+            }
+            if (node->isExpansionLocked()) {
+                return {"ParallelTreeReuse", false, "Expansion claim left on the tree" + at};
+            }
+        }
+
+        gs.applyAction(gs.myAnimal, result.bestAction);
+    }
+
+    if (pool.jobsRun() != TICKS) {
+        return {"ParallelTreeReuse", false, "Searches ran " + std::to_string(pool.jobsRun()) +
+                                            " jobs on the shared pool over " + std::to_string(TICKS) + " ticks"};
+    }
+    return {"ParallelTreeReuse", true, std::to_string(TICKS) + " ticks on one pool, " +
+                                       std::to_string(inheritedTotal) + " visits carried over"};
+}
+
+// Test: the time limit runs from the start time handed in, so a tick whose
+// budget went on conversion and map set-up searches no further
+TestResult runSearchDeadlineTest() {
+    std::cout << "\n=== Running Search Deadline Test ===" << std::endl;
+
+    GameState gs(11, 11);
+    auto topology = attachWalls(gs, borderWalls(11, 11));
+    gs.setCell(5, 5, CellContent::Pellet);
+    Animal me;
+    me.position = Position(1, 5);
+    gs.myAnimal = gs.addAnimal(me);
+    gs.remainingTicks = 100;
+
+    MCTSEngine engine(1.8, /*maxIterations*/3000, /*maxSimulationDepth*/15, /*timeLimit*/100, /*numThreads*/1);
+    auto tickStart = std::chrono::steady_clock::now() - std::chrono::milliseconds(200);
+    MCTSResult late = engine.findBestAction(gs, gs.myAnimal, tickStart);
+    if (engine.getTotalSimulations() != 0 || late.bestAction == BotAction::None) {
+        return {"SearchDeadline", false, std::to_string(engine.getTotalSimulations()) +
+                                         " simulations after the deadline had passed"};
+    }
+    engine.findBestAction(gs, gs.myAnimal);
+    if (engine.getTotalSimulations() == 0) {
+        return {"SearchDeadline", false, "A search started on time ran no simulations"};
+    }
+    return {"SearchDeadline", true, "Time spent before the search counts against its limit"};
+}
+
+TestResult runDistanceTableTest() {
+    std::cout << "\n=== Running Distance Table Test ===" << std::endl;
+
+    // A wall splits the map down to the bottom row, so (1,1) -> (5,1) must detour
+    GameState gs(7, 5);
+    BitBoard walls(7, 5);
+    for (int y = 0; y < 4; y++) {
+        walls.set(3, y);
+    }
+    gs.setCell(5, 1, CellContent::Pellet);
+
+    auto table = DistanceTable::forWalls(walls);
+    if (DistanceTable::forWalls(BitBoard(walls)) != table) {
+        return {"DistanceTable", false, "Same map built a second table"};
+    }
+
+    Position from(1, 1);
+    Position to(5, 1);
+    if (gs.distance(from, to) != from.manhattanDistance(to)) {
+        return {"DistanceTable", false, "Detached state did not fall back to Manhattan distance"};
+    }
+
+    auto topology = MapTopology::forWalls(walls);
+    if (&topology->getDistances() != table.get()) {
+        return {"DistanceTable", false, "Topology built its own table instead of sharing the map's"};
+    }
+    gs.setTopology(topology.get());
+    GameState copy = gs;
+    if (copy.distance(from, to) != 10 || copy.distanceToNearestPellet(from) != 10) {
+        return {"DistanceTable", false, "Expected a 10-step detour, got " + std::to_string(copy.distance(from, to))};
+    }
+
+    // A zookeeper chasing across the wall follows the detour instead of stalling at it
+    Animal prey;
+    prey.position = from;
+    Zookeeper zk;
+    zk.position = to;
+    zk.target = gs.addAnimal(prey);
+    if (gs.predictZookeeperPosition(zk, 2) != Position(4, 2) || gs.predictZookeeperPosition(zk, 10) != from) {
+        return {"DistanceTable", false, "Zookeeper prediction did not follow the shortest path"};
+    }
+
+    // Walls belong to the topology: the state refuses its own, and a
+    // re-initialised grid starts open again
+    bool rejected = false;
+    try {
+        gs.setCell(4, 4, CellContent::Wall);
+    } catch (const std::invalid_argument&) {
+        rejected = true;
+    }
+    if (!rejected || gs.getCell(3, 1) != CellContent::Wall || gs.getCell(4, 4) != CellContent::Empty) {
+        return {"DistanceTable", false, "State kept walls of its own"};
+    }
+    gs.initializeGrid(7, 5);
+    if (gs.getDistanceTable() != nullptr || !gs.isTraversable(3, 1)) {
+        return {"DistanceTable", false, "Table survived re-initialising the grid"};
+    }
+
+    return {"DistanceTable", true, "Wall-aware distances and chase steps shared across copies"};
+}
+
+TestResult runMapTopologyTest() {
+    std::cout << "\n=== Running Map Topology Test ===" << std::endl;
+
+    // 5x5 with a plus-shaped wall: a ring corridor, corner junctions on the
+    // border cross and a dead end poking into the middle
+    GameState gs(5, 5);
+    BitBoard walls(5, 5);
+    for (int i = 1; i < 4; i++) {
+        walls.set(2, i);
+        walls.set(i, 2);
+    }
+    walls.set(2, 2, false);
+    walls.set(2, 3, false);
+
+    auto topology = MapTopology::forWalls(walls);
+    if (MapTopology::forWalls(BitBoard(walls)) != topology) {
+        return {"MapTopology", false, "Same map built a second topology"};
+    }
+    if (topology->kind(topology->cellIndex(2, 1)) != CellKind::Wall ||
+        topology->kind(topology->cellIndex(0, 0)) != CellKind::Corridor ||
+        topology->kind(topology->cellIndex(2, 4)) != CellKind::Junction ||
+        topology->kind(topology->cellIndex(2, 2)) != CellKind::DeadEnd) {
+        return {"MapTopology", false, "Cells were classified wrongly"};
+    }
+    if (topology->neighbourMask(topology->cellIndex(2, 4)) !=
+            (MapTopology::OPEN_UP | MapTopology::OPEN_LEFT | MapTopology::OPEN_RIGHT) ||
+        topology->degree(topology->cellIndex(2, 4)) != 3) {
+        return {"MapTopology", false, "Wrong neighbour mask at (2,4)"};
+    }
+
+    // From every open cell the mask lookup must offer exactly the moves a
+    // scan of the walls does, item included
+    Animal animal;
+    animal.heldPowerUp = PowerUpType::Scavenger;
+    AnimalHandle handle = gs.addAnimal(animal);
+    gs.setTopology(topology.get());
+    for (int y = 0; y < 5; y++) {
+        for (int x = 0; x < 5; x++) {
+            if (!gs.isTraversable(x, y)) continue;
+            gs.animals[handle].position = Position(x, y);
+            ActionList expected;
+            if (!walls.get(x, y - 1) && y > 0) expected.push_back(BotAction::Up);
+            if (!walls.get(x, y + 1) && y < 4) expected.push_back(BotAction::Down);
+            if (!walls.get(x - 1, y) && x > 0) expected.push_back(BotAction::Left);
+            if (!walls.get(x + 1, y) && x < 4) expected.push_back(BotAction::Right);
+            expected.push_back(BotAction::UseItem);
+            ActionList actual = gs.getLegalActions(handle);
+            if (!std::equal(expected.begin(), expected.end(), actual.begin(), actual.end())) {
+                return {"MapTopology", false, "Legal actions differ at (" + std::to_string(x) + "," +
+                                              std::to_string(y) + ")"};
+            }
+        }
+    }
+
+    return {"MapTopology", true, "Neighbour masks, cell classes and legal moves match the walls"};
+}
+
+TestResult runBitBoardTest() {
+    std::cout << "\n=== Running BitBoard Test ===" << std::endl;
+
+    // Full 64-wide rows exercise the top bit of each word
+    BitBoard board(64, 3);
+    board.set(0, 1);
+    board.set(63, 1);
+    if (board.count() != 2 || !board.get(63, 1) || board.shiftRight().get(0, 1) || board.shiftRight().count() != 1) {
+        return {"BitBoard", false, "Edge bits not handled"};
+    }
+    if (!board.shiftUp().get(0, 0) || !board.shiftDown().get(63, 2) || !board.shiftLeft().get(62, 1)) {
+        return {"BitBoard", false, "Whole-board shifts misplaced bits"};
+    }
+
+    // Dilation stops at walls: a wall column at x = 2 blocks growth to the right
+    BitBoard open = ~BitBoard(64, 3);
+    for (int y = 0; y < 3; y++) open.set(2, y, false);
+    BitBoard grown = board;
+    for (int step = 0; step < 5; step++) grown = grown.dilate(open);
+    if (grown.get(2, 1) || grown.get(3, 1) || !grown.get(1, 0) || !grown.get(58, 1)) {
+        return {"BitBoard", false, "Dilation crossed a wall or failed to spread"};
+    }
+
+    int visited = 0;
+    grown.forEachInRect(0, 0, 1, 2, [&visited](int, int) { visited++; });
+    if (visited != 6 || grown.countInRect(0, 0, 1, 2) != 6 || grown.countInRect(-5, -5, 70, 70) != grown.count()) {
+        return {"BitBoard", false, "Region count or iteration disagrees"};
+    }
+
+    return {"BitBoard", true, "Shifts, dilation and region queries agree"};
+}
+
+// Test: once warmed up, the search loop itself never allocates. Two searches
+// differing only in iteration count must perform the same number of allocations,
+// and a batch of rollouts on the warmed engine must perform none.
+TestResult runAllocationFreeSearchTest() {
+    std::cout << "\n=== Running Allocation-Free Search Test ===" << std::endl;
+
+    GameState gs(11, 11);
+    auto topology = attachWalls(gs, borderWalls(11, 11));
+    for (int x = 2; x <= 8; x++) {
+        gs.setCell(x, 3, CellContent::Pellet);
+        gs.setCell(x, 7, CellContent::Pellet);
+    }
+    gs.setCell(5, 5, CellContent::Scavenger);
+
+    Animal me;
+    me.position = Position(1, 5);
+    me.spawnPosition = Position(1, 1);
+    gs.myAnimal = gs.addAnimal(me);
+    Zookeeper zk;
+    zk.position = Position(9, 9);
+    zk.target = gs.myAnimal;
+    gs.addZookeeper(zk);
+    gs.remainingTicks = 100;
+
+    MCTSEngine engine(1.8, /*maxIterations*/4000, /*maxSimulationDepth*/15, /*timeLimit*/10000, /*numThreads*/1);
+    engine.enableTreeReuse(false);
+    engine.findBestAction(gs, gs.myAnimal); // warm-up: pool slabs, tables, buffers
+
+    auto countAllocations = [&](int iterations) {
+        engine.setMaxIterations(iterations);
+        long long before = g_allocationCount.load();
+        engine.findBestAction(gs, gs.myAnimal);
+        return g_allocationCount.load() - before;
+    };
+    long long shortSearch = countAllocations(200);
+    long long longSearch = countAllocations(2000);
+
+    if (longSearch != shortSearch) {
+        return {"AllocationFreeSearch", false, std::to_string(longSearch - shortSearch) +
+                " extra allocations over 1800 extra iterations"};
+    }
+
+    // Rollouts on the warmed engine, measured directly: none may allocate
+    engine.playRollouts(gs, gs.myAnimal, 10);
+    long long before = g_allocationCount.load();
+    engine.playRollouts(gs, gs.myAnimal, 1000);
+    long long rolloutAllocations = g_allocationCount.load() - before;
+    if (rolloutAllocations != 0) {
+        return {"AllocationFreeSearch", false, std::to_string(rolloutAllocations) + " allocations over 1000 rollouts"};
+    }
+    return {"AllocationFreeSearch", true, "Rollouts allocation-free, search overhead fixed at " +
+                                          std::to_string(shortSearch) + " allocations"};
+}
+
+// Test: the compile-time heuristic pipeline scores legal actions exactly as
+// the virtual per-heuristic path does, including after weights change by name
+TestResult runHeuristicPipelineTest() {
+    std::cout << "\n=== Running Heuristic Pipeline Test ===" << std::endl;
+
+    const std::string jsonPath = "../../../../FunctionalTests/GameStates/805.json";
+    auto gameStateOpt = TestUtils::JsonGameStateLoader::loadStateFromFile(jsonPath, "AdvancedMCTSBot");
+    if (!gameStateOpt || gameStateOpt->myAnimal == INVALID_HANDLE) {
+        return {"HeuristicPipeline", false, "Could not load game state from " + jsonPath};
+    }
+    GameState& gs = *gameStateOpt;
+
+    // Both engines score the same gs; MovementConsistency reads its Animal::lastAction
+    HeuristicsEngine pipelined;
+    HeuristicsEngine dynamic;
+    auto compare = [&]() {
+        ActionScores fast = pipelined.evaluateAllActions(gs, gs.myAnimal);
+        for (BotAction action : gs.getLegalActions(gs.myAnimal)) {
+            double expected = 0.0;
+            for (const auto& contribution : dynamic.getHeuristicContributions(gs, gs.myAnimal, action)) {
+                expected += contribution.second;
+            }
+            if (std::abs(fast[static_cast<int>(action)] - expected) > 1e-9 * std::max(1.0, std::abs(expected))) {
+                return false;
+            }
+        }
+        return true;
+    };
+
+    if (!compare()) {
+        return {"HeuristicPipeline", false, "Default weights scored differently"};
+    }
+    pipelined.loadBalancedPreset();
+    dynamic.loadBalancedPreset();
+    pipelined.setHeuristicWeight("OpponentBlocking", 0.0);
+    dynamic.setHeuristicWeight("OpponentBlocking", 0.0);
+    if (!compare()) {
+        return {"HeuristicPipeline", false, "Weights set by name were not applied"};
+    }
+    return {"HeuristicPipeline", true, "Static and virtual scoring agree"};
+}
+
+// Test: a move into certain capture is proven lost at expansion, stops
+// drawing simulations and is never the move played
+TestResult runProvenLossTest() {
+    std::cout << "\n=== Running Proven Loss Test ===" << std::endl;
+
+    GameState gs(11, 11);
+    auto topology = attachWalls(gs, borderWalls(11, 11));
+    for (int x = 1; x <= 9; x++) {
+        gs.setCell(x, 2, CellContent::Pellet);
+        gs.setCell(x, 8, CellContent::Pellet);
+    }
+
+    // Stepping right lands next to the zookeeper, which then steps onto us
+    Animal me;
+    me.position = Position(5, 5);
+    me.spawnPosition = Position(1, 1);
+    gs.myAnimal = gs.addAnimal(me);
+    Zookeeper zk;
+    zk.position = Position(7, 5);
+    zk.target = gs.myAnimal;
+    gs.addZookeeper(zk);
+    gs.remainingTicks = 100;
+
+    MCTSEngine engine(1.8, /*maxIterations*/3000, /*maxSimulationDepth*/15, /*timeLimit*/10000, /*numThreads*/1);
+    engine.enableTreeReuse(false);
+    MCTSResult result = engine.findBestAction(gs, gs.myAnimal);
+
+    if (result.bestAction == BotAction::Right) {
+        return {"ProvenLoss", false, "Played a move into certain capture"};
+    }
+    for (const auto& stats : result.allActionStats) {
+        if (stats.action == BotAction::Right && stats.visits != 1) {
+            return {"ProvenLoss", false, "Capture move kept drawing simulations: " +
+                    std::to_string(stats.visits) + " visits"};
+        }
+    }
+    return {"ProvenLoss", true, "Capture move proven lost after its first simulation"};
+}
+
+TestResult runLazyChildStateTest() {
+    std::cout << "\n=== Running Lazy Child State Test ===" << std::endl;
+
+    GameState gs(11, 11);
+    auto topology = attachWalls(gs, borderWalls(11, 11));
+    for (int x = 2; x <= 8; x++) {
+        gs.setCell(x, 5, CellContent::Pellet);
+    }
+
+    Animal me;
+    me.position = Position(5, 5);
+    me.spawnPosition = Position(1, 1);
+    gs.myAnimal = gs.addAnimal(me);
+    gs.remainingTicks = 100;
+
+    NodePool pool;
+    MCTSNode* root = pool.createRoot(gs, gs.myAnimal);
+    GameState scratch = root->getGameState();
+    std::vector<StateDelta> undoLog;
+
+    // Expand every move, then one grandchild under each, replaying from the root
+    while (!root->isFullyExpandedNode()) {
+        MCTSNode* child = root->expand(pool, scratch, undoLog);
+        if (child == root || child->hasGameState()) {
+            return {"LazyChildState", false, "Expansion did not add a stateless child"};
+        }
+        MCTSNode* grandchild = child->expand(pool, scratch, undoLog);
+
+        GameState expected = gs;
+        expected.applyAction(gs.myAnimal, child->getAction());
+        if (child->getStateHash() != expected.hash()) {
+            return {"LazyChildState", false, "Child key does not match its replayed state"};
+        }
+        expected.applyAction(gs.myAnimal, grandchild->getAction());
+        if (grandchild->getStateHash() != expected.hash() || scratch.hash() != expected.hash()) {
+            return {"LazyChildState", false, "Grandchild state diverged from the replay"};
+        }
+
+        while (!undoLog.empty()) {
+            scratch.undo(undoLog.back());
+            undoLog.pop_back();
+        }
+    }
+
+    if (root->hasUntriedActions() || scratch.hash() != gs.hash()) {
+        return {"LazyChildState", false, "Root not fully expanded or scratch not rewound"};
+    }
+    // The untried-action mask hands out each legal move exactly once
+    uint32_t expanded = 0;
+    for (const MCTSNode* child : root->getChildren()) {
+        expanded |= 1u << static_cast<int>(child->getAction());
+    }
+    if (root->getChildren().size() != gs.getLegalActions(gs.myAnimal).size() ||
+        expanded != MCTSNode::legalActionMask(gs, gs.myAnimal)) {
+        return {"LazyChildState", false, "Children do not cover the legal moves once each"};
+    }
+    return {"LazyChildState", true, std::to_string(pool.nodeCount()) + " nodes share the root's single state"};
+}
+
 // Test 2: Test162 (existing functional test)
 TestResult runTest162() {
     std::cout << "\n=== Running Test162 ===" << std::endl;
@@ -156,12 +851,11 @@ TestResult runTest162() {
     }
     
     GameState& gs = *gameStateOpt;
-    if (gs.myAnimalId.empty()) {
+    if (gs.myAnimal == INVALID_HANDLE) {
         return {"Test162", false, "Bot '" + botNickname + "' not found in the game state."};
     }
     
     MctsService mcts(/*maxIterations*/1000000, /*timeLimitMs*/950, /*numThreads*/1, /*maxDepth*/20);
-    mcts.SetBotId(gs.myAnimalId);
     
     MCTSResult result = mcts.GetBestAction(gs);
     
@@ -194,12 +888,11 @@ TestResult runTest34() {
     }
     
     GameState& gs = *gameStateOpt;
-    if (gs.myAnimalId.empty()) {
+    if (gs.myAnimal == INVALID_HANDLE) {
         return {"Test34", false, "Bot '" + botNickname + "' not found in the game state."};
     }
     
     MctsService mcts(/*maxIterations*/1000000, /*timeLimitMs*/950, /*numThreads*/1, /*maxDepth*/20);
-    mcts.SetBotId(gs.myAnimalId);
     
     MCTSResult result = mcts.GetBestAction(gs);
     
@@ -225,12 +918,11 @@ TestResult runTest805() {
     }
     
     GameState& gs = *gameStateOpt;
-    if (gs.myAnimalId.empty()) {
+    if (gs.myAnimal == INVALID_HANDLE) {
         return {"Test805", false, "Bot '" + botNickname + "' not found in the game state."};
     }
     
     MctsService mcts(/*maxIterations*/1000000, /*timeLimitMs*/950, /*numThreads*/1, /*maxDepth*/20);
-    mcts.SetBotId(gs.myAnimalId);
     
     MCTSResult result = mcts.GetBestAction(gs);
     
@@ -250,6 +942,17 @@ int main() {
     
     // Run all tests
     results.push_back(runCycleDetectionTest());
+    results.push_back(runUndoRoundTripTest());
+    results.push_back(runTreeReuseTest());
+    results.push_back(runParallelTreeReuseTest());
+    results.push_back(runSearchDeadlineTest());
+    results.push_back(runDistanceTableTest());
+    results.push_back(runMapTopologyTest());
+    results.push_back(runBitBoardTest());
+    results.push_back(runAllocationFreeSearchTest());
+    results.push_back(runHeuristicPipelineTest());
+    results.push_back(runProvenLossTest());
+    results.push_back(runLazyChildStateTest());
     results.push_back(runTest162());
     results.push_back(runTest34());
     results.push_back(runTest805());
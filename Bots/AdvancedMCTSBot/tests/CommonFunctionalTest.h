@@ -32,13 +32,12 @@ inline int runScenario(const std::string& jsonPath,
     }
 
     GameState& gs = *gameStateOpt;
-    if (gs.myAnimalId.empty()) {
+    if (gs.myAnimal == INVALID_HANDLE) {
         std::cerr << "Test failed: Bot '" << botNickname << "' not found in the game state." << std::endl;
         return 1;
     }
 
     MctsService mcts(maxIterations, timeLimitMs, /*numThreads*/1, maxDepth);
-    mcts.SetBotId(gs.myAnimalId);
     MCTSResult result = mcts.GetBestAction(gs);
 
     std::cout << "--- MCTS Action-Score Breakdown --- " << botNickname << " ---" << std::endl;
@@ -1,4 +1,5 @@
 #include "JsonGameStateLoader.h"
+#include <algorithm>
 #include <climits>
 #include <stack>
 #include <unordered_set>
@@ -51,7 +52,8 @@ std::optional<GameState> JsonGameStateLoader::loadStateFromFile(const std::strin
     GameState gs(width, height);
     gs.tick = get_optional_value(data, "Tick", 0);
 
-    // Populate cells and bitboards
+    // Populate cells, with the walls going to the map's topology
+    BitBoard walls(width, height);
     if (data.contains("Cells") && data["Cells"].is_array()) {
         for (const auto& cell_json : data["Cells"]) {
             int x = get_optional_value(cell_json, "X", -1);
@@ -60,30 +62,36 @@ std::optional<GameState> JsonGameStateLoader::loadStateFromFile(const std::strin
             auto content = static_cast<CellContent>(content_int);
 
             if (gs.isValidPosition(x, y)) {
-                gs.setCell(x, y, content);
-                if (content == CellContent::Wall) gs.wallBoard.set(x, y);
-                else if (content == CellContent::Pellet) gs.pelletBoard.set(x, y);
-                else if (content == CellContent::PowerPellet) gs.powerUpBoard.set(x, y);
+                if (content == CellContent::Wall) walls.set(x, y);
+                else gs.setCell(x, y, content);
             }
         }
     }
 
+    // Loaded states only point at their topology, so every map loaded stays
+    // alive for the rest of the process; test runs load a handful
+    static std::vector<std::shared_ptr<const MapTopology>> loadedMaps;
+    auto topology = MapTopology::forWalls(walls);
+    if (std::find(loadedMaps.begin(), loadedMaps.end(), topology) == loadedMaps.end()) {
+        loadedMaps.push_back(topology);
+    }
+    gs.setTopology(topology.get());
+
     // Populate animals
     if (data.contains("Animals") && data["Animals"].is_array()) {
         for (const auto& animal_json : data["Animals"]) {
             Animal animal;
-            animal.id = get_optional_value<std::string>(animal_json, "Id", "");
-            animal.nickname = get_optional_value<std::string>(animal_json, "Nickname", "");
             animal.position = {get_optional_value(animal_json, "X", 0), get_optional_value(animal_json, "Y", 0)};
             animal.spawnPosition = {get_optional_value(animal_json, "SpawnX", 0), get_optional_value(animal_json, "SpawnY", 0)};
             animal.score = get_optional_value(animal_json, "Score", 0);
             animal.capturedCounter = get_optional_value(animal_json, "CapturedCounter", 0);
             animal.distanceCovered = get_optional_value(animal_json, "DistanceCovered", 0);
             animal.isViable = get_optional_value(animal_json, "IsViable", true);
-            gs.animals.push_back(animal);
+            AnimalHandle handle = gs.addAnimal(animal);
 
-            if (animal.nickname == myBotNickname) {
-                gs.myAnimalId = animal.id;
+            if (handle != INVALID_HANDLE &&
+                get_optional_value<std::string>(animal_json, "Nickname", "") == myBotNickname) {
+                gs.myAnimal = handle;
             }
         }
     }
@@ -92,28 +100,24 @@ std::optional<GameState> JsonGameStateLoader::loadStateFromFile(const std::strin
     if (data.contains("Zookeepers") && data["Zookeepers"].is_array()) {
         for (const auto& zk_json : data["Zookeepers"]) {
             Zookeeper zk;
-            zk.id = get_optional_value<std::string>(zk_json, "Id", "");
-            zk.nickname = get_optional_value<std::string>(zk_json, "Nickname", "");
             zk.position = {get_optional_value(zk_json, "X", 0), get_optional_value(zk_json, "Y", 0)};
             zk.spawnPosition = {get_optional_value(zk_json, "SpawnX", 0), get_optional_value(zk_json, "SpawnY", 0)};
-            gs.zookeepers.push_back(zk);
+            gs.addZookeeper(zk);
         }
     }
 
-    if (gs.myAnimalId.empty()) {
+    if (gs.myAnimal == INVALID_HANDLE) {
         std::cerr << "Warning: Bot with nickname '" << myBotNickname << "' not found in game state." << std::endl;
     }
 
     return gs;
 }
 
-StateAnalysis JsonGameStateLoader::analyzeState(const GameState& gs, const std::string& myBotNickname) {
+StateAnalysis JsonGameStateLoader::analyzeState(const GameState& gs) {
     StateAnalysis sa{};
 
-    const Animal* me = nullptr;
-    for (const auto& a : gs.animals) {
-        if (a.nickname == myBotNickname) { me = &a; break; }
-    }
+    // loadStateFromFile already resolved the bot nickname to gs.myAnimal
+    const Animal* me = gs.getMyAnimal();
     if (!me) {
         return sa; // default (invalid)
     }
@@ -198,7 +202,7 @@ StateAnalysis JsonGameStateLoader::analyzeState(const GameState& gs, const std::
 std::optional<StateAnalysis> JsonGameStateLoader::analyzeStateFromFile(const std::string& filePath, const std::string& myBotNickname) {
     auto gsOpt = JsonGameStateLoader::loadStateFromFile(filePath, myBotNickname);
     if (!gsOpt) return std::nullopt;
-    return analyzeState(*gsOpt, myBotNickname);
+    return analyzeState(*gsOpt);
 }
 
 }
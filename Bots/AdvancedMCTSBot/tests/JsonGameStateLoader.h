@@ -32,7 +32,7 @@ struct StateAnalysis {
     class JsonGameStateLoader {
 public:
     static std::optional<GameState> loadStateFromFile(const std::string& filePath, const std::string& myBotNickname);
-    static StateAnalysis analyzeState(const GameState& gs, const std::string& myBotNickname);
+    static StateAnalysis analyzeState(const GameState& gs);
     static std::optional<StateAnalysis> analyzeStateFromFile(const std::string& filePath, const std::string& myBotNickname);
 };
 